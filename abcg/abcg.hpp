@@ -10,10 +10,35 @@
 #ifndef ABCG_HPP_
 #define ABCG_HPP_
 
+#include "abcg_accumulationtarget.hpp"
 #include "abcg_application.hpp"
+#include "abcg_assetloader.hpp"
 #include "abcg_elapsedtimer.hpp"
+#include "abcg_fixedtimestep.hpp"
+#include "abcg_framepacer.hpp"
+#include "abcg_gpuprofiler.hpp"
 #include "abcg_image.hpp"
+#include "abcg_meshcache.hpp"
+#include "abcg_objparser.hpp"
+#include "abcg_programcache.hpp"
+#include "abcg_programfuture.hpp"
+#include "abcg_renderqueue.hpp"
+#include "abcg_shaderprogram.hpp"
+#include "abcg_streambuffer.hpp"
 #include "abcg_string.hpp"
+#include "abcg_tracer.hpp"
 #include "abcg_trackball.hpp"
+#include "abcg_uniformbuffer.hpp"
+#include "abcg_vertexwelder.hpp"
 
-#endif
\ No newline at end of file
+#endif
+
+// Route the draw calls of the application through abcg::gl so that they are
+// counted and, with ABCG_GL_STATE_CACHE, its state-changing OpenGL calls
+// through the state cache. Outside the include guard so that it takes effect
+// even if abcg_glstatecache.hpp was already included
+#define ABCG_GL_DRAW_REDIRECT
+#if defined(ABCG_GL_STATE_CACHE)
+#define ABCG_GL_STATE_CACHE_REDIRECT
+#endif
+#include "abcg_glstatecache.hpp"
\ No newline at end of file
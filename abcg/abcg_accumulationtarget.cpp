@@ -0,0 +1,134 @@
+/**
+ * @file abcg_accumulationtarget.cpp
+ * @brief Definition of abcg::AccumulationTarget class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_accumulationtarget.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+
+#include "abcg_exception.hpp"
+#include "abcg_openglfunctions.hpp"
+
+/**
+ * @brief Creates the framebuffer object and clears it to opaque black.
+ *
+ * Any framebuffer previously created by this object is destroyed.
+ *
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ *
+ * @throw abcg::Exception if the framebuffer is incomplete.
+ */
+void abcg::AccumulationTarget::create(int width, int height) {
+  destroy();
+
+  m_width = std::max(width, 1);
+  m_height = std::max(height, 1);
+
+  glGenRenderbuffers(1, &m_renderbuffer);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, m_renderbuffer);
+  const auto status{glCheckFramebufferStatus(GL_FRAMEBUFFER)};
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    destroy();
+    throw abcg::Exception{abcg::Exception::Runtime(fmt::format(
+        "Accumulation framebuffer is incomplete (status {:#x})", status))};
+  }
+
+  clear();
+}
+
+/**
+ * @brief Changes the size of the target, keeping its contents.
+ *
+ * The previous contents are scaled to the new size, so that what was drawn
+ * in normalized device coordinates stays in place. Does nothing if the size
+ * is unchanged.
+ *
+ * @param width New width in pixels.
+ * @param height New height in pixels.
+ */
+void abcg::AccumulationTarget::resize(int width, int height) {
+  if (m_framebuffer == 0) {
+    create(width, height);
+    return;
+  }
+  if (std::max(width, 1) == m_width && std::max(height, 1) == m_height) {
+    return;
+  }
+
+  // Keep the previous buffers alive while the new ones are created
+  AccumulationTarget previous{*this};
+  m_framebuffer = 0;
+  m_renderbuffer = 0;
+  create(width, height);
+
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, previous.m_framebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer);
+  glBlitFramebuffer(0, 0, previous.m_width, previous.m_height, 0, 0, m_width,
+                    m_height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  previous.destroy();
+}
+
+/**
+ * @brief Deletes the framebuffer and renderbuffer objects.
+ */
+void abcg::AccumulationTarget::destroy() {
+  if (m_framebuffer != 0) glDeleteFramebuffers(1, &m_framebuffer);
+  if (m_renderbuffer != 0) glDeleteRenderbuffers(1, &m_renderbuffer);
+  m_framebuffer = 0;
+  m_renderbuffer = 0;
+  m_width = 0;
+  m_height = 0;
+}
+
+/**
+ * @brief Binds the target for drawing and sets the viewport to cover it.
+ */
+void abcg::AccumulationTarget::bind() const {
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glViewport(0, 0, m_width, m_height);
+}
+
+/**
+ * @brief Clears the contents of the target.
+ *
+ * Leaves the default framebuffer bound. The clear color of the context is
+ * not changed.
+ *
+ * @param color Color to clear to.
+ */
+void abcg::AccumulationTarget::clear(const glm::vec4 &color) const {
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glClearBufferfv(GL_COLOR, 0, &color.r);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/**
+ * @brief Copies the target to the default framebuffer.
+ *
+ * Leaves the default framebuffer bound, so that the user interface is drawn
+ * on top of the copy.
+ */
+void abcg::AccumulationTarget::present() const {
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height,
+                    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
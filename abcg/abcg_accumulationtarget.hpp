@@ -0,0 +1,57 @@
+/**
+ * @file abcg_accumulationtarget.hpp
+ * @brief abcg::AccumulationTarget header file.
+ *
+ * Declaration of abcg::AccumulationTarget class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_ACCUMULATIONTARGET_HPP_
+#define ABCG_ACCUMULATIONTARGET_HPP_
+
+#include <glm/vec4.hpp>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+class AccumulationTarget;
+}  // namespace abcg
+
+/**
+ * @brief abcg::AccumulationTarget class.
+ *
+ * Off-screen color buffer for progressive rendering, in which each frame
+ * draws on top of the previous ones.
+ *
+ * The contents of the default framebuffer are undefined after a buffer swap
+ * unless the platform preserves them, which is costly on WebGL. Instead, the
+ * application draws into this target, which is never cleared implicitly,
+ * and copies it to the default framebuffer with present() every frame.
+ *
+ * The copy is a glBlitFramebuffer, which OpenGL ES and WebGL do not allow
+ * into a multisampled framebuffer, so the window should be created with
+ * OpenGLSettings::samples set to 0.
+ */
+class abcg::AccumulationTarget {
+ public:
+  void create(int width, int height);
+  void resize(int width, int height);
+  void destroy();
+
+  void bind() const;
+  void clear(const glm::vec4& color = {0.0f, 0.0f, 0.0f, 1.0f}) const;
+  void present() const;
+
+  [[nodiscard]] GLuint getId() const noexcept { return m_framebuffer; }
+  [[nodiscard]] int getWidth() const noexcept { return m_width; }
+  [[nodiscard]] int getHeight() const noexcept { return m_height; }
+
+ private:
+  GLuint m_framebuffer{};
+  GLuint m_renderbuffer{};
+  int m_width{};
+  int m_height{};
+};
+
+#endif
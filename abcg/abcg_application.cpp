@@ -10,13 +10,50 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cppitertools/itertools.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <gsl/gsl>
+#include <string_view>
+#include <type_traits>
 
 #include "SDL_image.h"
 #include "abcg_exception.hpp"
 #include "abcg_openglwindow.hpp"
+#include "abcg_tracer.hpp"
 #include "tiny_obj_loader.h"
 
+namespace {
+// Parses a positive number, or a non-negative number if allowZero is true
+template <typename T>
+T parseOption(std::string_view option, std::string_view value,
+              bool allowZero = false) {
+  T result{};
+  auto valid{false};
+  if constexpr (std::is_floating_point_v<T>) {
+    // std::from_chars for floating-point types is not available everywhere
+    const std::string text{value};
+    char *end{};
+    result = static_cast<T>(std::strtod(text.c_str(), &end));
+    valid = !text.empty() && end == text.c_str() + text.size() &&
+            std::isfinite(result);
+  } else {
+    const auto *const end{value.data() + value.size()};
+    const auto [ptr, error]{std::from_chars(value.data(), end, result)};
+    valid = error == std::errc{} && ptr == end;
+  }
+  if (!valid || result < T{} || (!allowZero && result == T{})) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Invalid value for {}: {}", option, value))};
+  }
+  return result;
+}
+}  // namespace
+
 #if defined(__EMSCRIPTEN__)
 void abcg::mainLoopCallback(void *userData) {
   abcg::Application &app = *(static_cast<abcg::Application *>(userData));
@@ -31,9 +68,66 @@ void abcg::mainLoopCallback(void *userData) {
  * Constructs an abcg::Application object and initializes the SDL library and
  * SDL subsystems.
  *
- * @throw abcg::Exception if SDL failed to initialize the subsystems.
+ * The following command-line options are supported on desktop platforms:
+ *
+ * - `--headless`: renders without a display, using the SDL offscreen video
+ * driver. The windows are hidden and the UI is not drawn.
+ * - `--frames N`: number of frames rendered in headless mode before exiting
+ * (default: 60), or number of measured frames in benchmark mode (default:
+ * 300). Must be positive.
+ * - `--output PATH`: in headless mode, saves the last frame to a PNG file.
+ * Windows other than the first get their index appended to the file name.
+ * - `--benchmark`: renders warm-up frames followed by measured frames with a
+ * fixed delta time, prints a JSON report of the measured frames (see
+ * abcg::BenchmarkRecorder::toJSON), and exits.
+ * - `--warmup N`: number of warm-up frames in benchmark mode (default: 60).
+ * May be zero.
+ * - `--delta-time SECONDS`: delta time of each frame in benchmark mode
+ * (default: 1/60). Must be positive.
+ * - `--report PATH`: in benchmark mode, writes the report to a file instead
+ * of the standard output.
+ * - `--trace PATH`: records CPU trace events (see abcg::Tracer) and writes
+ * them to a file on exit. Pressing F10 starts recording if it was not
+ * started, or writes the events recorded so far. The default path is
+ * `trace.json`.
+ *
+ * @throw abcg::Exception if SDL failed to initialize the subsystems, or if a
+ * command-line option is invalid.
  */
 abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
+#if !defined(__EMSCRIPTEN__)
+  const gsl::span args{argv, static_cast<std::size_t>(argc)};
+  for (std::size_t index{1}; index < args.size(); ++index) {
+    const std::string_view arg{args[index]};
+    const auto hasValue{index + 1 < args.size()};
+    if (arg == "--headless") {
+      m_headless = true;
+    } else if (arg == "--benchmark") {
+      m_benchmark = true;
+    } else if (arg == "--frames" && hasValue) {
+      m_frames = parseOption<int>(arg, args[++index]);
+    } else if (arg == "--warmup" && hasValue) {
+      m_warmupFrames = parseOption<int>(arg, args[++index], true);
+    } else if (arg == "--delta-time" && hasValue) {
+      m_fixedDeltaTime = parseOption<double>(arg, args[++index]);
+    } else if (arg == "--output" && hasValue) {
+      m_headlessOutput = args[++index];
+    } else if (arg == "--report" && hasValue) {
+      m_benchmarkReport = args[++index];
+    } else if (arg == "--trace" && hasValue) {
+      m_tracePath = args[++index];
+      Tracer::setEnabled(true);
+    }
+  }
+
+  if (m_headless) {
+    // Render through EGL without a display server, and do not require an
+    // audio device
+    SDL_setenv("SDL_VIDEODRIVER", "offscreen", 1);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+  }
+#endif
+
   Uint32 subsystemMask{SDL_INIT_TIMER | SDL_INIT_VIDEO | SDL_INIT_AUDIO |
                        SDL_INIT_JOYSTICK | SDL_INIT_GAMECONTROLLER |
                        SDL_INIT_EVENTS};
@@ -97,31 +191,135 @@ void abcg::Application::run(
 }
 
 void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) {
-  SDL_Event event{};
-  while (SDL_PollEvent(&event) != 0) {
+  {
+    ABCG_TRACE_SCOPE("Event pump");
+    SDL_Event event{};
+    while (SDL_PollEvent(&event) != 0) {
 #if !defined(__EMSCRIPTEN__)
-    if (event.type == SDL_QUIT) done = true;
+      if (event.type == SDL_QUIT) done = true;
+      if (event.type == SDL_KEYUP && event.key.keysym.sym == SDLK_F10) {
+        if (Tracer::isEnabled()) {
+          Tracer::writeChromeTrace(m_tracePath);
+        } else {
+          Tracer::setEnabled(true);
+        }
+      }
 #endif
-    for (const auto &window : m_windows) {
-      window->handleEvent(event, done);
+      for (const auto &window : m_windows) {
+        window->handleEvent(event, done);
+      }
     }
   }
   for (const auto &window : m_windows) {
+    ABCG_TRACE_SCOPE("paint");
     window->paint();
   }
 }
 
 void abcg::Application::run() {
   for (const auto &w : m_windows) {
+    w->m_headless = m_headless;
+    if (m_benchmark) w->m_fixedDeltaTime = m_fixedDeltaTime;
     w->initialize(m_basePath);
   }
 
 #if defined(__EMSCRIPTEN__)
-  emscripten_set_main_loop_arg(mainLoopCallback, this, 0, true);
+  // A frame rate of 0 uses requestAnimationFrame
+  emscripten_set_main_loop_arg(mainLoopCallback, this, getTargetFPS(), true);
 #else
+  if (m_benchmark) {
+    runBenchmark();
+  } else if (m_headless) {
+    paintFrames(m_frames > 0 ? m_frames : 60);
+  } else {
+    m_framePacer.setTargetFPS(getTargetFPS());
+    bool done{};
+    while (!done) {
+      waitWhileIdle();
+      mainLoopIterator(done);
+      m_framePacer.wait();
+    };
+  }
+
+  if (Tracer::isEnabled()) Tracer::writeChromeTrace(m_tracePath);
+#endif
+}
+
+// Returns the frame rate limit of the main loop, or 0 if there is no limit
+int abcg::Application::getTargetFPS() const {
+  auto targetFPS{0};
+  for (const auto &window : m_windows) {
+    const auto windowFPS{window->m_openGLSettings.targetFPS};
+    if (windowFPS <= 0) return 0;
+    targetFPS = std::max(targetFPS, windowFPS);
+  }
+  return targetFPS;
+}
+
+// Blocks until an event arrives or the idle timeout expires, if all windows
+// are idle. The event is left in the queue
+void abcg::Application::waitWhileIdle() const {
+  if (!std::all_of(m_windows.begin(), m_windows.end(),
+                   [](const auto &window) { return window->isIdle(); })) {
+    return;
+  }
+  // Paint now and then anyway, e.g., for UI elements that fade
+  const auto idleTimeout{250};
+  SDL_WaitEventTimeout(nullptr, idleTimeout);
+}
+
+// Paints a number of frames and returns false if the application was closed
+// before. With --headless and --output, the last frame is saved
+bool abcg::Application::paintFrames(int frames) {
   bool done{};
-  while (!done) {
+  for (auto frame : iter::range(frames)) {
+    if (frame == frames - 1 && m_headless && !m_headlessOutput.empty()) {
+      for (auto index : iter::range(m_windows.size())) {
+        std::filesystem::path path{m_headlessOutput};
+        if (index > 0) {
+          path.replace_filename(fmt::format("{}-{}{}", path.stem().string(),
+                                            index,
+                                            path.extension().string()));
+        }
+        m_windows.at(index)->m_capturePath = path.string();
+      }
+    }
     mainLoopIterator(done);
-  };
-#endif
+    if (done) return false;
+  }
+  return true;
+}
+
+// Paints the warm-up and measured frames, and reports the measured frames of
+// each window as JSON
+void abcg::Application::runBenchmark() {
+  if (!paintFrames(m_warmupFrames)) return;
+
+  const auto frames{m_frames > 0 ? m_frames : 300};
+  for (const auto &window : m_windows) {
+    SDL_GL_MakeCurrent(window->m_window, window->m_GLContext);
+    window->m_benchmarkRecorder = std::make_unique<BenchmarkRecorder>();
+    window->m_benchmarkRecorder->start(static_cast<std::size_t>(frames));
+  }
+
+  if (!paintFrames(frames)) return;
+
+  std::string report{fmt::format(
+      "{{\n  \"warmupFrames\": {},\n  \"deltaTime\": {},\n  \"windows\": [",
+      m_warmupFrames, m_fixedDeltaTime)};
+  for (auto index : iter::range(m_windows.size())) {
+    const auto &window{m_windows.at(index)};
+    SDL_GL_MakeCurrent(window->m_window, window->m_GLContext);
+    report += fmt::format(
+        "{}\n    {}", index > 0 ? "," : "",
+        window->m_benchmarkRecorder->toJSON(window->m_windowSettings.title));
+  }
+  report += "\n  ]\n}\n";
+
+  if (m_benchmarkReport.empty()) {
+    fmt::print("{}", report);
+  } else if (std::ofstream file{m_benchmarkReport}; !(file << report)) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Failed to write report to {}", m_benchmarkReport))};
+  }
 }
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "abcg_exception.hpp"
+#include "abcg_framepacer.hpp"
 #include "abcg_openglwindow.hpp"
 
 namespace abcg {
@@ -49,9 +50,26 @@ class abcg::Application {
  private:
   void mainLoopIterator(bool& done);
   void run();
+  [[nodiscard]] int getTargetFPS() const;
+  void waitWhileIdle() const;
+  bool paintFrames(int frames);
+  void runBenchmark();
 
   std::string m_basePath;
   std::vector<std::unique_ptr<OpenGLWindow>> m_windows;
+  FramePacer m_framePacer;
+
+  // Command-line options of the headless and benchmark modes
+  bool m_headless{false};
+  bool m_benchmark{false};
+  int m_frames{};
+  int m_warmupFrames{60};
+  double m_fixedDeltaTime{1.0 / 60.0};
+  std::string m_headlessOutput;
+  std::string m_benchmarkReport;
+
+  // Output of the CPU trace (--trace or F10)
+  std::string m_tracePath{"trace.json"};
 
 #if defined(__EMSCRIPTEN__)
   friend void mainLoopCallback(void* userData);
@@ -0,0 +1,120 @@
+/**
+ * @file abcg_assetloader.cpp
+ * @brief Definition of abcg::AssetLoader class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_assetloader.hpp"
+
+#include <algorithm>
+
+#include "abcg_elapsedtimer.hpp"
+#include "abcg_tracer.hpp"
+
+/**
+ * @brief Constructs an abcg::AssetLoader object.
+ *
+ * @param numThreads Number of worker threads. If zero, uses one thread less
+ * than the number of hardware threads (at least one). Ignored in WebAssembly
+ * builds.
+ */
+abcg::AssetLoader::AssetLoader([[maybe_unused]] unsigned int numThreads) {
+#if !defined(__EMSCRIPTEN__)
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+  }
+  m_workers.reserve(numThreads);
+  for (unsigned int i{}; i < numThreads; ++i) {
+    m_workers.emplace_back(&AssetLoader::workerLoop, this);
+  }
+#endif
+}
+
+/**
+ * @brief Destroys the abcg::AssetLoader object.
+ *
+ * Jobs that have not started are discarded. Jobs that are running are
+ * finished, but their upload stage is not executed.
+ */
+abcg::AssetLoader::~AssetLoader() {
+  {
+    const std::lock_guard lock{m_mutex};
+    m_stop = true;
+    m_jobs.clear();
+  }
+  m_condition.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Executes pending upload stages.
+ *
+ * Runs upload callbacks of finished loads until the queue is empty or the
+ * upload budget is exhausted. At least one upload is executed per call, so
+ * that progress is made even with a zero budget.
+ *
+ * Must be called from the thread that owns the OpenGL context.
+ */
+void abcg::AssetLoader::processUploads() {
+  ElapsedTimer timer;
+  do {
+    Job upload;
+    {
+      const std::lock_guard lock{m_mutex};
+      if (m_uploads.empty() && m_workers.empty() && !m_jobs.empty()) {
+        // No worker threads: run the load stage here
+        upload = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      } else if (!m_uploads.empty()) {
+        upload = std::move(m_uploads.front());
+        m_uploads.pop_front();
+        --m_pendingCount;
+      } else {
+        return;
+      }
+    }
+    upload();
+  } while (timer.elapsed() < m_uploadBudget);
+}
+
+/**
+ * @brief Returns the number of assets that have not finished loading.
+ *
+ * @return Number of enqueued assets whose upload stage has not run yet.
+ */
+std::size_t abcg::AssetLoader::getPendingCount() const {
+  const std::lock_guard lock{m_mutex};
+  return m_pendingCount;
+}
+
+void abcg::AssetLoader::enqueueJob(Job job) {
+  {
+    const std::lock_guard lock{m_mutex};
+    m_jobs.push_back(std::move(job));
+    ++m_pendingCount;
+  }
+  m_condition.notify_one();
+}
+
+void abcg::AssetLoader::pushUpload(Job upload) {
+  const std::lock_guard lock{m_mutex};
+  m_uploads.push_back(std::move(upload));
+}
+
+void abcg::AssetLoader::workerLoop() {
+  while (true) {
+    Job job;
+    {
+      std::unique_lock lock{m_mutex};
+      m_condition.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+      if (m_stop) return;
+      job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    ABCG_TRACE_SCOPE("AssetLoader job");
+    job();
+  }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file abcg_assetloader.hpp
+ * @brief abcg::AssetLoader header file.
+ *
+ * Declaration of abcg::AssetLoader class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_ASSETLOADER_HPP_
+#define ABCG_ASSETLOADER_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace abcg {
+class AssetLoader;
+}  // namespace abcg
+
+/**
+ * @brief abcg::AssetLoader class.
+ *
+ * Loads assets in two stages: a CPU stage (e.g., parsing a mesh or decoding
+ * an image) that runs on a pool of worker threads, and an upload stage (e.g.,
+ * creating GL buffers and textures) that runs on the thread that owns the
+ * OpenGL context.
+ *
+ * Upload callbacks are queued as soon as their CPU stage finishes and are
+ * executed by processUploads(), which abcg::OpenGLWindow calls once per frame
+ * under a time budget.
+ *
+ * In WebAssembly builds there are no worker threads, and both stages run in
+ * processUploads().
+ */
+class abcg::AssetLoader {
+ public:
+  explicit AssetLoader(unsigned int numThreads = 0);
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader(AssetLoader&&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+  AssetLoader& operator=(AssetLoader&&) = delete;
+
+  template <typename T>
+  void enqueue(std::function<T()> load, std::function<void(T&)> upload);
+
+  void processUploads();
+
+  [[nodiscard]] std::size_t getPendingCount() const;
+  [[nodiscard]] double getUploadBudget() const noexcept {
+    return m_uploadBudget;
+  }
+  void setUploadBudget(double seconds) noexcept { m_uploadBudget = seconds; }
+
+ private:
+  using Job = std::function<void()>;
+
+  void enqueueJob(Job job);
+  void pushUpload(Job upload);
+  void workerLoop();
+
+  std::vector<std::thread> m_workers;
+  std::deque<Job> m_jobs;
+  std::deque<Job> m_uploads;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::size_t m_pendingCount{};
+  bool m_stop{};
+
+  // Maximum time spent on uploads per frame, in seconds
+  double m_uploadBudget{0.004};
+};
+
+/**
+ * @brief Enqueues an asset to be loaded asynchronously.
+ *
+ * @tparam T Type of the CPU payload produced by the load stage. Must be
+ * default constructible and move assignable.
+ * @param load Function that produces the payload. Runs on a worker thread and
+ * must not call OpenGL functions.
+ * @param upload Function that consumes the payload. Runs on the OpenGL thread
+ * during abcg::OpenGLWindow::paint.
+ *
+ * Exceptions thrown by the load stage are rethrown on the OpenGL thread when
+ * the upload stage would have run.
+ */
+template <typename T>
+void abcg::AssetLoader::enqueue(std::function<T()> load,
+                                std::function<void(T&)> upload) {
+  enqueueJob([this, load = std::move(load), upload = std::move(upload)]() {
+    auto payload{std::make_shared<T>()};
+    std::exception_ptr exception{};
+    try {
+      *payload = load();
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    pushUpload([payload, exception, upload]() {
+      if (exception) std::rethrow_exception(exception);
+      upload(*payload);
+    });
+  });
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file abcg_benchmark.cpp
+ * @brief Definition of abcg::BenchmarkRecorder class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_benchmark.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "abcg_openglfunctions.hpp"
+#include "abcg_string.hpp"
+
+namespace {
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double> &sorted, double p) {
+  const auto rank{static_cast<std::size_t>(
+      std::ceil(p * static_cast<double>(sorted.size())))};
+  return sorted.at(std::max<std::size_t>(rank, 1) - 1);
+}
+
+std::string summarize(std::vector<double> values) {
+  if (values.empty()) return "null";
+  std::sort(values.begin(), values.end());
+  const auto mean{std::accumulate(values.begin(), values.end(), 0.0) /
+                  static_cast<double>(values.size())};
+  return fmt::format(
+      R"({{"mean": {:.4f}, "p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, )"
+      R"("max": {:.4f}}})",
+      mean, percentile(values, 0.50), percentile(values, 0.95),
+      percentile(values, 0.99), values.back());
+}
+}  // namespace
+
+abcg::BenchmarkRecorder::~BenchmarkRecorder() { deleteQueries(); }
+
+/**
+ * @brief Starts recording a number of frames.
+ *
+ * Any previous recording is discarded. GPU times are recorded only if timer
+ * queries are supported.
+ *
+ * @param frames Number of frames to record.
+ */
+void abcg::BenchmarkRecorder::start(std::size_t frames) {
+  deleteQueries();
+  m_frames = frames;
+  m_cpuTimes.clear();
+  m_cpuTimes.reserve(frames);
+  m_draws.clear();
+  m_draws.reserve(frames);
+
+#if !defined(__EMSCRIPTEN__)
+  if ((GLEW_VERSION_3_3 != GL_FALSE || GLEW_ARB_timer_query != GL_FALSE) &&
+      frames > 0) {
+    m_queries.resize(frames);
+    glGenQueries(static_cast<GLsizei>(frames), m_queries.data());
+  }
+#endif
+}
+
+/**
+ * @brief Marks the start of a frame.
+ *
+ * Has no effect if all frames were already recorded.
+ */
+void abcg::BenchmarkRecorder::beginFrame() {
+  if (!isRecording()) return;
+  m_frameTimer.restart();
+#if !defined(__EMSCRIPTEN__)
+  if (!m_queries.empty()) {
+    glBeginQuery(GL_TIME_ELAPSED, m_queries.at(m_cpuTimes.size()));
+  }
+#endif
+}
+
+/**
+ * @brief Marks the end of a frame.
+ *
+ * Has no effect if all frames were already recorded.
+ *
+ * @param draws Number of draw calls issued in the frame.
+ */
+void abcg::BenchmarkRecorder::endFrame(std::size_t draws) {
+  if (!isRecording()) return;
+#if !defined(__EMSCRIPTEN__)
+  if (!m_queries.empty()) glEndQuery(GL_TIME_ELAPSED);
+#endif
+  m_cpuTimes.push_back(m_frameTimer.elapsed() * 1000.0);
+  m_draws.push_back(draws);
+}
+
+/**
+ * @brief Summarizes the recorded frames as a JSON object.
+ *
+ * Waits for the results of the GPU timer queries, then deletes the queries.
+ * Times are in milliseconds. Each of the `cpuTimeMs`, `gpuTimeMs` and
+ * `drawCalls` members holds the mean, the 50th, 95th and 99th percentiles,
+ * and the maximum, or is null if not available.
+ *
+ * @param name Name to identify the recording.
+ * @return JSON object in a single line.
+ */
+std::string abcg::BenchmarkRecorder::toJSON(std::string_view name) {
+  std::vector<double> gpuTimes;
+#if !defined(__EMSCRIPTEN__)
+  if (!m_queries.empty()) {
+    gpuTimes.reserve(m_cpuTimes.size());
+    for (std::size_t frame{}; frame < m_cpuTimes.size(); ++frame) {
+      GLuint64 nanoseconds{};
+      glGetQueryObjectui64v(m_queries.at(frame), GL_QUERY_RESULT,
+                            &nanoseconds);
+      gpuTimes.push_back(static_cast<double>(nanoseconds) * 1e-6);
+    }
+  }
+#endif
+  deleteQueries();
+
+  const std::vector<double> draws(m_draws.begin(), m_draws.end());
+
+  return fmt::format(
+      R"({{"name": "{}", "frames": {}, "cpuTimeMs": {}, "gpuTimeMs": {}, )"
+      R"("drawCalls": {}}})",
+      escapeJSON(name), m_cpuTimes.size(), summarize(m_cpuTimes),
+      summarize(gpuTimes), summarize(draws));
+}
+
+void abcg::BenchmarkRecorder::deleteQueries() {
+  if (m_queries.empty()) return;
+#if !defined(__EMSCRIPTEN__)
+  glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+#endif
+  m_queries.clear();
+}
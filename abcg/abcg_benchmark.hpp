@@ -0,0 +1,67 @@
+/**
+ * @file abcg_benchmark.hpp
+ * @brief abcg::BenchmarkRecorder header file.
+ *
+ * Declaration of abcg::BenchmarkRecorder class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_BENCHMARK_HPP_
+#define ABCG_BENCHMARK_HPP_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "abcg_elapsedtimer.hpp"
+#include "abcg_external.hpp"
+
+namespace abcg {
+class BenchmarkRecorder;
+}  // namespace abcg
+
+/**
+ * @brief abcg::BenchmarkRecorder class.
+ *
+ * Records the CPU time, GPU time and number of draw calls of a sequence of
+ * frames, and summarizes them as a JSON object.
+ *
+ * GPU times are measured with one GL_TIME_ELAPSED query per frame. Query
+ * results are only read by toJSON(), so recording does not stall the
+ * pipeline.
+ *
+ * An OpenGL context must be current when calling any member function,
+ * including the destructor.
+ */
+class abcg::BenchmarkRecorder {
+ public:
+  BenchmarkRecorder() = default;
+  ~BenchmarkRecorder();
+
+  BenchmarkRecorder(const BenchmarkRecorder&) = delete;
+  BenchmarkRecorder(BenchmarkRecorder&&) = delete;
+  BenchmarkRecorder& operator=(const BenchmarkRecorder&) = delete;
+  BenchmarkRecorder& operator=(BenchmarkRecorder&&) = delete;
+
+  void start(std::size_t frames);
+  void beginFrame();
+  void endFrame(std::size_t draws);
+  [[nodiscard]] std::string toJSON(std::string_view name);
+
+  [[nodiscard]] bool isRecording() const noexcept {
+    return m_cpuTimes.size() < m_frames;
+  }
+
+ private:
+  std::size_t m_frames{};
+  std::vector<double> m_cpuTimes;
+  std::vector<std::size_t> m_draws;
+  std::vector<GLuint> m_queries;
+  ElapsedTimer m_frameTimer;
+
+  void deleteQueries();
+};
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file abcg_cachefile.cpp
+ * @brief Definition of helper functions shared by the on-disk caches.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_cachefile.hpp"
+
+#include <fmt/core.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+/**
+ * @brief Continues a 64-bit FNV-1a hash with a sequence of bytes.
+ *
+ * @param data Pointer to the bytes.
+ * @param size Number of bytes.
+ * @param hash Hash of the preceding data, or the offset basis to start a new
+ * hash.
+ * @return Updated hash.
+ */
+std::uint64_t abcg::cachefile::fnv1a(const void *data, std::size_t size,
+                                     std::uint64_t hash) {
+  const auto *bytes{static_cast<const unsigned char *>(data)};
+  for (std::size_t i{}; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/**
+ * @brief Continues a 64-bit FNV-1a hash with a string.
+ *
+ * The size is hashed before the characters, so that consecutive strings
+ * cannot be confused with a different split of the same characters.
+ *
+ * @param str String to hash.
+ * @param hash Hash of the preceding data.
+ * @return Updated hash.
+ */
+std::uint64_t abcg::cachefile::fnv1aString(std::string_view str,
+                                           std::uint64_t hash) {
+  const std::uint64_t size{str.size()};
+  hash = fnv1aValue(size, hash);
+  return fnv1a(str.data(), str.size(), hash);
+}
+
+/**
+ * @brief Reads a whole file with a single bulk read.
+ *
+ * @param path Path to the file.
+ * @param contents Receives the contents of the file.
+ * @return true on success; false if the file does not exist or cannot be
+ * read.
+ */
+bool abcg::cachefile::readFile(std::string_view path,
+                               std::vector<std::byte> &contents) {
+  std::ifstream input(std::string{path}, std::ios::binary | std::ios::ate);
+  if (!input) return false;
+  const auto fileSize{input.tellg()};
+  if (fileSize < 0) return false;
+
+  contents.resize(static_cast<std::size_t>(fileSize));
+  input.seekg(0);
+  return static_cast<bool>(
+      input.read(reinterpret_cast<char *>(contents.data()), fileSize));
+}
+
+/**
+ * @brief Replaces a file with the concatenation of byte ranges.
+ *
+ * The data is written to a temporary file that is then renamed, so that
+ * readers never see a partially written file. Failing to write is not an
+ * error for a cache: a warning is printed and the file is left as it was.
+ *
+ * @param path Path to the file.
+ * @param parts Byte ranges written in sequence.
+ * @param description What the file contains (e.g., "mesh cache"), used in
+ * warnings.
+ * @return true on success.
+ */
+bool abcg::cachefile::writeFile(
+    std::string_view path,
+    std::initializer_list<std::span<const std::byte>> parts,
+    std::string_view description) {
+  const auto tempPath{std::string{path} + ".tmp"};
+  std::error_code error;
+  {
+    std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+    if (!output) {
+      fmt::print("Warning: failed to create {} {}\n", description, path);
+      return false;
+    }
+    for (const auto &part : parts) {
+      output.write(reinterpret_cast<const char *>(part.data()),
+                   static_cast<std::streamsize>(part.size()));
+    }
+    if (!output) {
+      fmt::print("Warning: failed to write {} {}\n", description, path);
+      output.close();
+      std::filesystem::remove(tempPath, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(tempPath, path, error);
+  if (error) {
+    fmt::print("Warning: failed to write {} {} ({})\n", description, path,
+               error.message());
+    std::filesystem::remove(tempPath, error);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file abcg_cachefile.hpp
+ * @brief Declaration of helper functions shared by the on-disk caches.
+ *
+ * Used by abcg::MeshCache and abcg::ProgramCache. Not part of the public
+ * interface of the library.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_CACHEFILE_HPP_
+#define ABCG_CACHEFILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace abcg::cachefile {
+/** @brief Initial value of an FNV-1a hash. */
+constexpr std::uint64_t fnv1aOffsetBasis{0xcbf29ce484222325ULL};
+
+[[nodiscard]] std::uint64_t fnv1a(const void *data, std::size_t size,
+                                  std::uint64_t hash = fnv1aOffsetBasis);
+[[nodiscard]] std::uint64_t fnv1aString(std::string_view str,
+                                        std::uint64_t hash);
+
+/**
+ * @brief Continues a 64-bit FNV-1a hash with the bytes of a value.
+ *
+ * @param value Value of a trivially copyable type without padding.
+ * @param hash Hash of the preceding data.
+ * @return Updated hash.
+ */
+template <typename T>
+[[nodiscard]] std::uint64_t fnv1aValue(const T &value, std::uint64_t hash) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  return fnv1a(&value, sizeof(value), hash);
+}
+
+[[nodiscard]] bool readFile(std::string_view path,
+                            std::vector<std::byte> &contents);
+bool writeFile(std::string_view path,
+               std::initializer_list<std::span<const std::byte>> parts,
+               std::string_view description);
+}  // namespace abcg::cachefile
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file abcg_fixedtimestep.cpp
+ * @brief Definition of abcg::FixedTimestep class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_fixedtimestep.hpp"
+
+#include <fmt/core.h>
+
+#include "abcg_exception.hpp"
+
+/**
+ * @brief Constructs an abcg::FixedTimestep object.
+ *
+ * @param tickRate Number of steps per second.
+ * @param maxSteps Maximum number of steps per call to advance().
+ *
+ * @throw abcg::Exception if tickRate or maxSteps is not positive.
+ */
+abcg::FixedTimestep::FixedTimestep(double tickRate, int maxSteps) {
+  setTickRate(tickRate);
+  setMaxSteps(maxSteps);
+}
+
+/**
+ * @brief Discards the accumulated time.
+ *
+ * Call after a pause, so that the time spent paused is not simulated.
+ */
+void abcg::FixedTimestep::reset() noexcept { m_accumulator = 0.0; }
+
+/**
+ * @brief Sets the number of steps per second.
+ *
+ * @param tickRate Number of steps per second.
+ *
+ * @throw abcg::Exception if tickRate is not positive.
+ */
+void abcg::FixedTimestep::setTickRate(double tickRate) {
+  if (!(tickRate > 0.0)) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Invalid tick rate: {}", tickRate))};
+  }
+  m_step = 1.0 / tickRate;
+  m_accumulator = std::fmod(m_accumulator, m_step);
+}
+
+/**
+ * @brief Sets the maximum number of steps per call to advance().
+ *
+ * @param maxSteps Maximum number of steps.
+ *
+ * @throw abcg::Exception if maxSteps is not positive.
+ */
+void abcg::FixedTimestep::setMaxSteps(int maxSteps) {
+  if (maxSteps <= 0) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Invalid maximum number of steps: {}", maxSteps))};
+  }
+  m_maxSteps = maxSteps;
+}
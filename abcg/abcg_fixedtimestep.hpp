@@ -0,0 +1,88 @@
+/**
+ * @file abcg_fixedtimestep.hpp
+ * @brief abcg::FixedTimestep header file.
+ *
+ * Declaration of abcg::FixedTimestep class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FIXEDTIMESTEP_HPP_
+#define ABCG_FIXEDTIMESTEP_HPP_
+
+#include <algorithm>
+#include <cmath>
+
+namespace abcg {
+class FixedTimestep;
+}  // namespace abcg
+
+/**
+ * @brief abcg::FixedTimestep class.
+ *
+ * Runs a simulation at a fixed tick rate, independently of the frame rate.
+ *
+ * Each call to advance() adds the frame time to an accumulator and calls the
+ * update function once for each whole step in it. The fraction of a step
+ * left in the accumulator is returned as an interpolation factor between the
+ * states of the last two steps, so that rendering is smooth even when the
+ * frame rate is not a multiple of the tick rate.
+ *
+ * If a frame takes longer than the maximum number of steps, the time that
+ * cannot be simulated is dropped, and the simulation runs slower than real
+ * time instead of falling further behind.
+ */
+class abcg::FixedTimestep {
+ public:
+  explicit FixedTimestep(double tickRate = 60.0, int maxSteps = 8);
+
+  template <typename F>
+  // requires std::invocable<F, double>
+  double advance(double deltaTime, F&& update);
+  void reset() noexcept;
+
+  void setTickRate(double tickRate);
+  void setMaxSteps(int maxSteps);
+
+  /** @brief Returns the duration of a step, in seconds. */
+  [[nodiscard]] double getStep() const noexcept { return m_step; }
+  /** @brief Returns the interpolation factor of the last advance(). */
+  [[nodiscard]] double getAlpha() const noexcept {
+    return m_accumulator / m_step;
+  }
+
+ private:
+  double m_step{};
+  int m_maxSteps{};
+  double m_accumulator{};
+};
+
+/**
+ * @brief Advances the simulation by the time of a frame.
+ *
+ * @param deltaTime Time of the frame, in seconds.
+ * @param update Function called with the step duration, in seconds, for each
+ * step.
+ *
+ * @return Interpolation factor in [0, 1) between the states before and after
+ * the last step.
+ */
+template <typename F>
+// requires std::invocable<F, double>
+double abcg::FixedTimestep::advance(double deltaTime, F&& update) {
+  m_accumulator += std::max(deltaTime, 0.0);
+
+  auto steps{0};
+  while (m_accumulator >= m_step && steps < m_maxSteps) {
+    update(m_step);
+    m_accumulator -= m_step;
+    ++steps;
+  }
+
+  // Drop the time that could not be simulated in this frame
+  if (m_accumulator >= m_step) m_accumulator = std::fmod(m_accumulator, m_step);
+
+  return getAlpha();
+}
+
+#endif
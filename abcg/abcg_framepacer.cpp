@@ -0,0 +1,59 @@
+/**
+ * @file abcg_framepacer.cpp
+ * @brief Definition of abcg::FramePacer class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_framepacer.hpp"
+
+#include <algorithm>
+#include <thread>
+
+/**
+ * @brief Sets the target frame rate.
+ *
+ * @param fps Frames per second. If not positive, wait() returns immediately.
+ */
+void abcg::FramePacer::setTargetFPS(double fps) noexcept {
+  m_period = fps > 0.0 ? std::chrono::duration_cast<clock::duration>(
+                             std::chrono::duration<double>{1.0 / fps})
+                       : clock::duration{};
+  m_nextFrame = clock::now();
+}
+
+/**
+ * @brief Waits until the next frame is due.
+ *
+ * Frames are due at regular intervals. If the caller is late by more than a
+ * frame, the schedule restarts from the current time instead of returning
+ * immediately until it catches up.
+ */
+void abcg::FramePacer::wait() {
+  if (m_period == clock::duration{}) return;
+
+  m_nextFrame += m_period;
+  auto now{clock::now()};
+  if (now >= m_nextFrame) {
+    if (now - m_nextFrame > m_period) m_nextFrame = now;
+    return;
+  }
+
+  // Sleep until shortly before the frame is due
+  if (const auto wakeUp{m_nextFrame - m_sleepError}; wakeUp > now) {
+    std::this_thread::sleep_until(wakeUp);
+    now = clock::now();
+
+    // Follow increases of the sleep error quickly and decreases slowly. A
+    // single late wake-up should not turn the next frames into spins
+    const auto error{now - wakeUp};
+    m_sleepError = error > m_sleepError ? (m_sleepError + error) / 2
+                                        : (m_sleepError * 15 + error) / 16;
+    m_sleepError = std::min(m_sleepError, m_period / 2);
+  }
+
+  // Spin for the rest
+  while (clock::now() < m_nextFrame) {
+    std::this_thread::yield();
+  }
+}
@@ -0,0 +1,42 @@
+/**
+ * @file abcg_framepacer.hpp
+ * @brief abcg::FramePacer header file.
+ *
+ * Declaration of abcg::FramePacer class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAMEPACER_HPP_
+#define ABCG_FRAMEPACER_HPP_
+
+#include <chrono>
+
+namespace abcg {
+class FramePacer;
+}  // namespace abcg
+
+/**
+ * @brief abcg::FramePacer class.
+ *
+ * Limits the rate of a loop by waiting until the next frame is due.
+ *
+ * The thread sleeps for most of the wait and spins for the last stretch. The
+ * length of the spin adapts to how much the sleeps of the system overshoot,
+ * so that frames start on time without keeping the CPU busy.
+ */
+class abcg::FramePacer {
+ public:
+  void setTargetFPS(double fps) noexcept;
+  void wait();
+
+ private:
+  using clock = std::chrono::steady_clock;
+
+  clock::duration m_period{};
+  clock::time_point m_nextFrame{clock::now()};
+  // Estimate of how late sleeps wake up
+  clock::duration m_sleepError{std::chrono::milliseconds{1}};
+};
+
+#endif
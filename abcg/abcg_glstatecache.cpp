@@ -0,0 +1,415 @@
+/**
+ * @file abcg_glstatecache.cpp
+ * @brief Definition of the OpenGL state cache functions.
+ *
+ * This file must not see the redirection macros of abcg_glstatecache.hpp, as
+ * it issues the actual OpenGL calls.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_glstatecache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+
+namespace {
+// Value of a shadowed name or enum that is not known
+constexpr GLuint unknown{~GLuint{}};
+
+// Texture units with shadowed bindings. Units beyond these are always issued
+constexpr std::size_t maxTextureUnits{32};
+
+// Capabilities with shadowed enable state
+constexpr std::array cachedCaps{
+    GLenum{GL_BLEND},        GLenum{GL_CULL_FACE},
+    GLenum{GL_DEPTH_TEST},   GLenum{GL_POLYGON_OFFSET_FILL},
+    GLenum{GL_SCISSOR_TEST}, GLenum{GL_STENCIL_TEST},
+#if !defined(__EMSCRIPTEN__)
+    GLenum{GL_MULTISAMPLE},  GLenum{GL_PROGRAM_POINT_SIZE},
+#endif
+};
+
+struct TextureUnit {
+  GLuint texture2D{unknown};
+  GLuint textureCubeMap{unknown};
+};
+
+struct State {
+  GLuint program{unknown};
+  GLuint vertexArray{unknown};
+  // The element array buffer binding is part of the VAO state
+  GLuint elementArrayBuffer{unknown};
+  GLuint arrayBuffer{unknown};
+  GLuint uniformBuffer{unknown};
+  GLenum activeTexture{unknown};
+  std::array<TextureUnit, maxTextureUnits> textureUnits{};
+  // 1 if enabled, 0 if disabled, -1 if unknown
+  std::array<int, cachedCaps.size()> caps{};
+  GLenum blendEquation{unknown};
+  std::pair<GLenum, GLenum> blendFunc{unknown, unknown};
+  GLenum depthFunc{unknown};
+  GLuint depthMask{unknown};
+  GLenum cullFace{unknown};
+  GLenum frontFace{unknown};
+
+  State() { caps.fill(-1); }
+};
+
+State state;
+abcg::gl::StateCacheCounters counters;
+
+// Sets the shadow value and returns true if the call must be issued
+template <typename T>
+bool update(T &shadow, T value) noexcept {
+  if (shadow == value) {
+    ++counters.elided;
+    return false;
+  }
+  shadow = value;
+  ++counters.issued;
+  return true;
+}
+
+GLuint *findBufferBinding(GLenum target) noexcept {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+      return &state.arrayBuffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return &state.elementArrayBuffer;
+    case GL_UNIFORM_BUFFER:
+      return &state.uniformBuffer;
+    default:
+      return nullptr;
+  }
+}
+
+GLuint *findTextureBinding(GLenum target) noexcept {
+  const auto unit{state.activeTexture - GL_TEXTURE0};
+  if (state.activeTexture == unknown || unit >= maxTextureUnits) {
+    return nullptr;
+  }
+  auto &textureUnit{state.textureUnits.at(unit)};
+  switch (target) {
+    case GL_TEXTURE_2D:
+      return &textureUnit.texture2D;
+    case GL_TEXTURE_CUBE_MAP:
+      return &textureUnit.textureCubeMap;
+    default:
+      return nullptr;
+  }
+}
+
+int *findCap(GLenum cap) noexcept {
+  const auto *it{std::find(cachedCaps.begin(), cachedCaps.end(), cap)};
+  if (it == cachedCaps.end()) return nullptr;
+  return &state.caps.at(static_cast<std::size_t>(it - cachedCaps.begin()));
+}
+
+// Names that are deleted while bound revert to zero
+void resetDeleted(GLuint &binding, std::span<const GLuint> names) noexcept {
+  if (std::find(names.begin(), names.end(), binding) != names.end()) {
+    binding = 0;
+  }
+}
+}  // namespace
+
+/**
+ * @brief Marks all shadowed state as unknown.
+ *
+ * Must be called after OpenGL state is changed by calls that do not go
+ * through abcg::gl, so that the next calls are issued.
+ */
+void abcg::gl::invalidateStateCache() noexcept { state = State{}; }
+
+/**
+ * @brief Returns the number of issued and elided calls, and of draw calls.
+ *
+ * @return Counters accumulated since the last call to
+ * resetStateCacheCounters().
+ */
+abcg::gl::StateCacheCounters abcg::gl::getStateCacheCounters() noexcept {
+  return counters;
+}
+
+/**
+ * @brief Resets the issued, elided and draw call counters to zero.
+ */
+void abcg::gl::resetStateCacheCounters() noexcept { counters = {}; }
+
+/**
+ * @brief Selects the active texture unit, unless it is already active.
+ *
+ * @param texture Texture unit (GL_TEXTUREi).
+ */
+void abcg::gl::activeTexture(GLenum texture) {
+  if (update(state.activeTexture, texture)) glActiveTexture(texture);
+}
+
+/**
+ * @brief Binds a buffer, unless it is already bound.
+ *
+ * Only GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER and GL_UNIFORM_BUFFER are
+ * shadowed. Other targets are always issued.
+ *
+ * @param target Buffer binding target.
+ * @param buffer Name of the buffer object.
+ */
+void abcg::gl::bindBuffer(GLenum target, GLuint buffer) {
+  if (auto *binding{findBufferBinding(target)}) {
+    if (!update(*binding, buffer)) return;
+  } else {
+    ++counters.issued;
+  }
+  glBindBuffer(target, buffer);
+}
+
+/**
+ * @brief Binds a buffer to an indexed binding point.
+ *
+ * Always issued. Indexed bindings are not shadowed, but the generic binding
+ * they also change is updated.
+ *
+ * @param target Buffer binding target.
+ * @param index Index of the binding point.
+ * @param buffer Name of the buffer object.
+ */
+void abcg::gl::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+  if (target == GL_UNIFORM_BUFFER) state.uniformBuffer = buffer;
+  ++counters.issued;
+  glBindBufferBase(target, index, buffer);
+}
+
+/**
+ * @brief Binds a texture to the active texture unit, unless it is already
+ * bound.
+ *
+ * Only GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are shadowed. Other targets are
+ * always issued.
+ *
+ * @param target Texture target.
+ * @param texture Name of the texture object.
+ */
+void abcg::gl::bindTexture(GLenum target, GLuint texture) {
+  if (auto *binding{findTextureBinding(target)}) {
+    if (!update(*binding, texture)) return;
+  } else {
+    ++counters.issued;
+  }
+  glBindTexture(target, texture);
+}
+
+/**
+ * @brief Binds a vertex array object, unless it is already bound.
+ *
+ * @param array Name of the vertex array object.
+ */
+void abcg::gl::bindVertexArray(GLuint array) {
+  if (!update(state.vertexArray, array)) return;
+  state.elementArrayBuffer = unknown;
+  glBindVertexArray(array);
+}
+
+/**
+ * @brief Sets the blend equation, unless it is already set.
+ *
+ * @param mode Blend equation.
+ */
+void abcg::gl::blendEquation(GLenum mode) {
+  if (update(state.blendEquation, mode)) glBlendEquation(mode);
+}
+
+/**
+ * @brief Sets the blend function, unless it is already set.
+ *
+ * @param sfactor Source factor.
+ * @param dfactor Destination factor.
+ */
+void abcg::gl::blendFunc(GLenum sfactor, GLenum dfactor) {
+  if (update(state.blendFunc, {sfactor, dfactor})) {
+    glBlendFunc(sfactor, dfactor);
+  }
+}
+
+/**
+ * @brief Sets the faces to cull, unless they are already set.
+ *
+ * @param mode Faces to cull.
+ */
+void abcg::gl::cullFace(GLenum mode) {
+  if (update(state.cullFace, mode)) glCullFace(mode);
+}
+
+/**
+ * @brief Deletes buffer objects and resets the bindings that refer to them.
+ *
+ * @param n Number of buffers.
+ * @param buffers Names of the buffers.
+ */
+void abcg::gl::deleteBuffers(GLsizei n, const GLuint *buffers) {
+  const std::span names{buffers, static_cast<std::size_t>(n)};
+  resetDeleted(state.arrayBuffer, names);
+  resetDeleted(state.elementArrayBuffer, names);
+  resetDeleted(state.uniformBuffer, names);
+  ++counters.issued;
+  glDeleteBuffers(n, buffers);
+}
+
+/**
+ * @brief Deletes texture objects and resets the bindings that refer to them.
+ *
+ * @param n Number of textures.
+ * @param textures Names of the textures.
+ */
+void abcg::gl::deleteTextures(GLsizei n, const GLuint *textures) {
+  const std::span names{textures, static_cast<std::size_t>(n)};
+  for (auto &textureUnit : state.textureUnits) {
+    resetDeleted(textureUnit.texture2D, names);
+    resetDeleted(textureUnit.textureCubeMap, names);
+  }
+  ++counters.issued;
+  glDeleteTextures(n, textures);
+}
+
+/**
+ * @brief Deletes vertex array objects and resets the binding if it refers to
+ * one of them.
+ *
+ * @param n Number of vertex array objects.
+ * @param arrays Names of the vertex array objects.
+ */
+void abcg::gl::deleteVertexArrays(GLsizei n, const GLuint *arrays) {
+  const std::span names{arrays, static_cast<std::size_t>(n)};
+  if (std::find(names.begin(), names.end(), state.vertexArray) !=
+      names.end()) {
+    state.vertexArray = 0;
+    state.elementArrayBuffer = 0;
+  }
+  ++counters.issued;
+  glDeleteVertexArrays(n, arrays);
+}
+
+/**
+ * @brief Sets the depth comparison function, unless it is already set.
+ *
+ * @param func Depth comparison function.
+ */
+void abcg::gl::depthFunc(GLenum func) {
+  if (update(state.depthFunc, func)) glDepthFunc(func);
+}
+
+/**
+ * @brief Draws arrays and counts the draw call.
+ *
+ * @param mode Primitive type.
+ * @param first First vertex.
+ * @param count Number of vertices.
+ */
+void abcg::gl::drawArrays(GLenum mode, GLint first, GLsizei count) {
+  ++counters.draws;
+  glDrawArrays(mode, first, count);
+}
+
+/**
+ * @brief Draws instances of arrays and counts the draw call.
+ *
+ * @param mode Primitive type.
+ * @param first First vertex.
+ * @param count Number of vertices.
+ * @param instancecount Number of instances.
+ */
+void abcg::gl::drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                                   GLsizei instancecount) {
+  ++counters.draws;
+  glDrawArraysInstanced(mode, first, count, instancecount);
+}
+
+/**
+ * @brief Draws indexed primitives and counts the draw call.
+ *
+ * @param mode Primitive type.
+ * @param count Number of indices.
+ * @param type Type of the indices.
+ * @param indices Offset of the first index in the element array buffer.
+ */
+void abcg::gl::drawElements(GLenum mode, GLsizei count, GLenum type,
+                            const void *indices) {
+  ++counters.draws;
+  glDrawElements(mode, count, type, indices);
+}
+
+/**
+ * @brief Draws instances of indexed primitives and counts the draw call.
+ *
+ * @param mode Primitive type.
+ * @param count Number of indices.
+ * @param type Type of the indices.
+ * @param indices Offset of the first index in the element array buffer.
+ * @param instancecount Number of instances.
+ */
+void abcg::gl::drawElementsInstanced(GLenum mode, GLsizei count, GLenum type,
+                                     const void *indices,
+                                     GLsizei instancecount) {
+  ++counters.draws;
+  glDrawElementsInstanced(mode, count, type, indices, instancecount);
+}
+
+/**
+ * @brief Enables or disables writing into the depth buffer, unless it is
+ * already in that state.
+ *
+ * @param flag Whether the depth buffer is writable.
+ */
+void abcg::gl::depthMask(GLboolean flag) {
+  if (update(state.depthMask, GLuint{flag == GL_FALSE ? 0U : 1U})) {
+    glDepthMask(flag);
+  }
+}
+
+/**
+ * @brief Disables a capability, unless it is already disabled.
+ *
+ * @param cap Capability.
+ */
+void abcg::gl::disable(GLenum cap) {
+  if (auto *enabled{findCap(cap)}) {
+    if (!update(*enabled, 0)) return;
+  } else {
+    ++counters.issued;
+  }
+  glDisable(cap);
+}
+
+/**
+ * @brief Enables a capability, unless it is already enabled.
+ *
+ * @param cap Capability.
+ */
+void abcg::gl::enable(GLenum cap) {
+  if (auto *enabled{findCap(cap)}) {
+    if (!update(*enabled, 1)) return;
+  } else {
+    ++counters.issued;
+  }
+  glEnable(cap);
+}
+
+/**
+ * @brief Sets the front-facing winding order, unless it is already set.
+ *
+ * @param mode Winding order.
+ */
+void abcg::gl::frontFace(GLenum mode) {
+  if (update(state.frontFace, mode)) glFrontFace(mode);
+}
+
+/**
+ * @brief Installs a program object, unless it is already in use.
+ *
+ * @param program Name of the program object.
+ */
+void abcg::gl::useProgram(GLuint program) {
+  if (update(state.program, program)) glUseProgram(program);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file abcg_glstatecache.hpp
+ * @brief Header file of the OpenGL state cache.
+ *
+ * Declaration of the state-tracking OpenGL functions in abcg::gl.
+ *
+ * When ABCG_GL_STATE_CACHE is defined (CMake option ABCG_GL_STATE_CACHE),
+ * every call listed below, made from abcg or from code that includes
+ * abcg.hpp, is routed through these functions. State changes that would set
+ * a state to the value it already has are not issued.
+ *
+ * Draw calls are routed through the draw functions below in every build, so
+ * that the number of draw calls (e.g., in the --benchmark report) is known
+ * even without the state cache. They are always issued.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_GLSTATECACHE_HPP_
+#define ABCG_GLSTATECACHE_HPP_
+
+#include <cstddef>
+
+#include "abcg_external.hpp"
+
+namespace abcg::gl {
+/**
+ * @brief Number of state-changing calls issued to OpenGL and elided by the
+ * state cache, and number of draw calls.
+ */
+struct StateCacheCounters {
+  std::size_t issued{};
+  std::size_t elided{};
+  std::size_t draws{};
+};
+
+void invalidateStateCache() noexcept;
+[[nodiscard]] StateCacheCounters getStateCacheCounters() noexcept;
+void resetStateCacheCounters() noexcept;
+
+void activeTexture(GLenum texture);
+void bindBuffer(GLenum target, GLuint buffer);
+void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void bindTexture(GLenum target, GLuint texture);
+void bindVertexArray(GLuint array);
+void blendEquation(GLenum mode);
+void blendFunc(GLenum sfactor, GLenum dfactor);
+void cullFace(GLenum mode);
+void deleteBuffers(GLsizei n, const GLuint* buffers);
+void deleteTextures(GLsizei n, const GLuint* textures);
+void deleteVertexArrays(GLsizei n, const GLuint* arrays);
+void depthFunc(GLenum func);
+void drawArrays(GLenum mode, GLint first, GLsizei count);
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                         GLsizei instancecount);
+void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type,
+                           const void* indices, GLsizei instancecount);
+void depthMask(GLboolean flag);
+void disable(GLenum cap);
+void enable(GLenum cap);
+void frontFace(GLenum mode);
+void useProgram(GLuint program);
+}  // namespace abcg::gl
+
+#endif
+
+// Kept outside the include guard so that a later inclusion can turn the
+// redirections on after the declarations above were seen without them
+#if defined(ABCG_GL_STATE_CACHE_REDIRECT) && \
+    !defined(ABCG_GL_STATE_CACHE_REDIRECTED)
+#define ABCG_GL_STATE_CACHE_REDIRECTED
+#undef glActiveTexture
+#undef glBindBuffer
+#undef glBindBufferBase
+#undef glBindTexture
+#undef glBindVertexArray
+#undef glBlendEquation
+#undef glBlendFunc
+#undef glCullFace
+#undef glDeleteBuffers
+#undef glDeleteTextures
+#undef glDeleteVertexArrays
+#undef glDepthFunc
+#undef glDepthMask
+#undef glDisable
+#undef glEnable
+#undef glFrontFace
+#undef glUseProgram
+#define glActiveTexture abcg::gl::activeTexture
+#define glBindBuffer abcg::gl::bindBuffer
+#define glBindBufferBase abcg::gl::bindBufferBase
+#define glBindTexture abcg::gl::bindTexture
+#define glBindVertexArray abcg::gl::bindVertexArray
+#define glBlendEquation abcg::gl::blendEquation
+#define glBlendFunc abcg::gl::blendFunc
+#define glCullFace abcg::gl::cullFace
+#define glDeleteBuffers abcg::gl::deleteBuffers
+#define glDeleteTextures abcg::gl::deleteTextures
+#define glDeleteVertexArrays abcg::gl::deleteVertexArrays
+#define glDepthFunc abcg::gl::depthFunc
+#define glDepthMask abcg::gl::depthMask
+#define glDisable abcg::gl::disable
+#define glEnable abcg::gl::enable
+#define glFrontFace abcg::gl::frontFace
+#define glUseProgram abcg::gl::useProgram
+#endif
+
+#if defined(ABCG_GL_DRAW_REDIRECT) && !defined(ABCG_GL_DRAW_REDIRECTED)
+#define ABCG_GL_DRAW_REDIRECTED
+#undef glDrawArrays
+#undef glDrawArraysInstanced
+#undef glDrawElements
+#undef glDrawElementsInstanced
+#define glDrawArrays abcg::gl::drawArrays
+#define glDrawArraysInstanced abcg::gl::drawArraysInstanced
+#define glDrawElements abcg::gl::drawElements
+#define glDrawElementsInstanced abcg::gl::drawElementsInstanced
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file abcg_gpuprofiler.cpp
+ * @brief Definition of abcg::GpuProfiler class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_gpuprofiler.hpp"
+
+#include "abcg_openglfunctions.hpp"
+
+abcg::GpuProfiler::~GpuProfiler() {
+  if (m_current == this) m_current = nullptr;
+#if !defined(__EMSCRIPTEN__)
+  for (auto &frame : m_frames) {
+    if (!frame.queries.empty()) {
+      glDeleteQueries(static_cast<GLsizei>(frame.queries.size()),
+                      frame.queries.data());
+    }
+  }
+#endif
+}
+
+/**
+ * @brief Returns whether timestamp queries are supported by the current
+ * OpenGL context.
+ *
+ * @return True if OpenGL 3.3 or ARB_timer_query is supported.
+ */
+bool abcg::GpuProfiler::isSupported() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  return GLEW_VERSION_3_3 != GL_FALSE || GLEW_ARB_timer_query != GL_FALSE;
+#endif
+}
+
+/**
+ * @brief Starts a frame.
+ *
+ * Reads the results of the frame that used the same set of queries, if they
+ * are available.
+ */
+void abcg::GpuProfiler::beginFrame() {
+  m_frameIndex = (m_frameIndex + 1) % frameLatency;
+  auto &frame{m_frames.at(m_frameIndex)};
+  if (frame.pending) readResults(frame);
+
+  frame.usedQueries = 0;
+  frame.zones.clear();
+  m_zoneStack.clear();
+  m_inFrame = true;
+
+  // Reference for the start times of the zones
+  issueTimestamp();
+}
+
+/**
+ * @brief Ends the frame. Zones still open are closed.
+ */
+void abcg::GpuProfiler::endFrame() {
+  if (!m_inFrame) return;
+  while (!m_zoneStack.empty()) popZone();
+  m_frames.at(m_frameIndex).pending = true;
+  m_inFrame = false;
+}
+
+/**
+ * @brief Opens a zone nested in the currently open zone.
+ *
+ * @param name Name of the zone.
+ */
+void abcg::GpuProfiler::pushZone(std::string_view name) {
+  if (!m_inFrame) return;
+  auto &zones{m_frames.at(m_frameIndex).zones};
+  zones.push_back({std::string{name}, static_cast<int>(m_zoneStack.size()),
+                   issueTimestamp(), 0});
+  m_zoneStack.push_back(zones.size() - 1);
+}
+
+/**
+ * @brief Closes the most recently opened zone.
+ */
+void abcg::GpuProfiler::popZone() {
+  if (!m_inFrame || m_zoneStack.empty()) return;
+  auto &zones{m_frames.at(m_frameIndex).zones};
+  zones.at(m_zoneStack.back()).endQuery = issueTimestamp();
+  m_zoneStack.pop_back();
+}
+
+// Records a timestamp with the next query of the current frame and returns
+// the index of the query
+std::size_t abcg::GpuProfiler::issueTimestamp() {
+  auto &frame{m_frames.at(m_frameIndex)};
+#if !defined(__EMSCRIPTEN__)
+  if (frame.usedQueries == frame.queries.size()) {
+    GLuint query{};
+    glGenQueries(1, &query);
+    frame.queries.push_back(query);
+  }
+  glQueryCounter(frame.queries.at(frame.usedQueries), GL_TIMESTAMP);
+#endif
+  return frame.usedQueries++;
+}
+
+void abcg::GpuProfiler::readResults(Frame &frame) {
+  frame.pending = false;
+#if !defined(__EMSCRIPTEN__)
+  // Queries complete in order, so the last one is checked
+  GLint available{};
+  glGetQueryObjectiv(frame.queries.at(frame.usedQueries - 1),
+                     GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE) return;
+
+  std::vector<GLuint64> timestamps(frame.usedQueries);
+  for (std::size_t index{}; index < frame.usedQueries; ++index) {
+    glGetQueryObjectui64v(frame.queries.at(index), GL_QUERY_RESULT,
+                          &timestamps.at(index));
+  }
+
+  const auto toMilliseconds{[&](std::size_t from, std::size_t to) {
+    return static_cast<double>(timestamps.at(to) - timestamps.at(from)) * 1e-6;
+  }};
+  m_results.clear();
+  for (const auto &zone : frame.zones) {
+    m_results.push_back({zone.name, zone.depth,
+                         toMilliseconds(0, zone.beginQuery),
+                         toMilliseconds(zone.beginQuery, zone.endQuery)});
+  }
+#endif
+}
@@ -0,0 +1,142 @@
+/**
+ * @file abcg_gpuprofiler.hpp
+ * @brief abcg::GpuProfiler header file.
+ *
+ * Declaration of abcg::GpuProfiler class and ABCG_GPU_ZONE macro.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_GPUPROFILER_HPP_
+#define ABCG_GPUPROFILER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+class GpuProfiler;
+}  // namespace abcg
+
+#define ABCG_GPU_ZONE_CONCAT_(a, b) a##b
+#define ABCG_GPU_ZONE_CONCAT(a, b) ABCG_GPU_ZONE_CONCAT_(a, b)
+
+/**
+ * @brief Measures the GPU time of the commands issued until the end of the
+ * enclosing scope.
+ *
+ * Has no effect outside abcg::OpenGLWindow::paintGL, or if timer queries are
+ * not supported.
+ */
+#define ABCG_GPU_ZONE(name)                                 \
+  const abcg::GpuProfiler::Zone ABCG_GPU_ZONE_CONCAT(       \
+      abcgGpuZone, __LINE__) {                              \
+    name                                                    \
+  }
+
+/**
+ * @brief abcg::GpuProfiler class.
+ *
+ * Measures the GPU time of nested zones of a frame with GL_TIMESTAMP queries.
+ *
+ * Queries are kept in frameLatency sets that are used in turn. The results
+ * of a frame are read when its set is about to be reused, frameLatency - 1
+ * frames later. If they are not available by then, they are discarded, so
+ * reading results never stalls the pipeline.
+ *
+ * abcg::OpenGLWindow creates a profiler if timer queries are supported, and
+ * makes it current while paintGL() is called.
+ */
+class abcg::GpuProfiler {
+ public:
+  /** @brief Number of frames in flight before results are read. */
+  static constexpr std::size_t frameLatency{3};
+
+  /** @brief Measured zone. Times are relative to the start of the frame. */
+  struct Result {
+    std::string name;
+    int depth{};
+    double startMs{};
+    double durationMs{};
+  };
+
+  class Zone;
+
+  GpuProfiler() = default;
+  ~GpuProfiler();
+
+  GpuProfiler(const GpuProfiler&) = delete;
+  GpuProfiler(GpuProfiler&&) = delete;
+  GpuProfiler& operator=(const GpuProfiler&) = delete;
+  GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+  [[nodiscard]] static bool isSupported();
+  [[nodiscard]] static GpuProfiler* getCurrent() noexcept { return m_current; }
+  static void setCurrent(GpuProfiler* profiler) noexcept {
+    m_current = profiler;
+  }
+
+  void beginFrame();
+  void endFrame();
+  void pushZone(std::string_view name);
+  void popZone();
+
+  /** @brief Returns the zones of the most recent frame with results. */
+  [[nodiscard]] const std::vector<Result>& getResults() const noexcept {
+    return m_results;
+  }
+
+ private:
+  struct ZoneRecord {
+    std::string name;
+    int depth{};
+    std::size_t beginQuery{};
+    std::size_t endQuery{};
+  };
+
+  struct Frame {
+    std::vector<GLuint> queries;
+    std::size_t usedQueries{};
+    std::vector<ZoneRecord> zones;
+    bool pending{false};
+  };
+
+  std::array<Frame, frameLatency> m_frames{};
+  std::size_t m_frameIndex{};
+  std::vector<std::size_t> m_zoneStack;
+  std::vector<Result> m_results;
+  bool m_inFrame{false};
+
+  static inline GpuProfiler* m_current{};
+
+  std::size_t issueTimestamp();
+  void readResults(Frame& frame);
+};
+
+/**
+ * @brief Measures a zone of the current profiler from construction to
+ * destruction.
+ */
+class abcg::GpuProfiler::Zone {
+ public:
+  explicit Zone(std::string_view name) : m_profiler{getCurrent()} {
+    if (m_profiler != nullptr) m_profiler->pushZone(name);
+  }
+  ~Zone() {
+    if (m_profiler != nullptr) m_profiler->popZone();
+  }
+
+  Zone(const Zone&) = delete;
+  Zone(Zone&&) = delete;
+  Zone& operator=(const Zone&) = delete;
+  Zone& operator=(Zone&&) = delete;
+
+ private:
+  GpuProfiler* m_profiler{};
+};
+
+#endif
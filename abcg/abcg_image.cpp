@@ -17,6 +17,7 @@
 #include "SDL_image.h"
 #include "abcg_exception.hpp"
 #include "abcg_external.hpp"
+#include "abcg_openglfunctions.hpp"
 
 void flipY(gsl::not_null<SDL_Surface*> surface) {
   auto width{static_cast<size_t>(surface->w * surface->format->BytesPerPixel)};
@@ -38,72 +39,115 @@ void flipY(gsl::not_null<SDL_Surface*> surface) {
   }
 }
 
-GLuint abcg::opengl::loadTexture(std::string_view path, bool generateMipmaps) {
-  GLuint textureID{};
-
-  // Copy file data into buffer
-  std::ifstream input(path.data(), std::ios::binary);
-  if (!input) {
+/**
+ * @brief Decodes an image file into CPU memory.
+ *
+ * This function does not call OpenGL and can be used from worker threads.
+ *
+ * @param path Path to the image file.
+ * @return Decoded image, converted to RGB or RGBA and flipped vertically.
+ *
+ * @throw abcg::Exception if the file cannot be opened or decoded.
+ */
+abcg::ImageData abcg::loadImage(std::string_view path) {
+  if (std::ifstream input(path.data(), std::ios::binary); !input) {
     throw abcg::Exception{abcg::Exception::Runtime(
         fmt::format("Failed to open texture file {}", path))};
   }
-  std::vector<char> buffer((std::istreambuf_iterator<char>(input)),
-                           std::istreambuf_iterator<char>());
-
-  // Load the bitmap
-  if (SDL_Surface * surface{IMG_Load(path.data())}) {
-    // Enforce RGB/RGBA
-    GLenum format{0};
-    SDL_Surface* formattedSurface{nullptr};
-    if (surface->format->BytesPerPixel == 3) {
-      formattedSurface =
-          SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGB24, 0);
-      format = GL_RGB;
-    } else {
-      formattedSurface =
-          SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
-      format = GL_RGBA;
-    }
-    SDL_FreeSurface(surface);
 
-    // Flip horizontally
-    flipY(formattedSurface);
+  SDL_Surface* surface{IMG_Load(path.data())};
+  if (surface == nullptr) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Failed to load texture file {}", path))};
+  }
 
-    // Generate the texture
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(format),
-                 formattedSurface->w, formattedSurface->h, 0, format,
-                 GL_UNSIGNED_BYTE, formattedSurface->pixels);
+  // Enforce RGB/RGBA
+  ImageData image{};
+  SDL_Surface* formattedSurface{nullptr};
+  if (surface->format->BytesPerPixel == 3) {
+    formattedSurface =
+        SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGB24, 0);
+    image.format = GL_RGB;
+  } else {
+    formattedSurface =
+        SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    image.format = GL_RGBA;
+  }
+  SDL_FreeSurface(surface);
+  if (formattedSurface == nullptr) {
+    throw abcg::Exception{abcg::Exception::SDL(
+        fmt::format("Failed to convert texture file {}", path))};
+  }
 
-    SDL_FreeSurface(formattedSurface);
+  image.width = formattedSurface->w;
+  image.height = formattedSurface->h;
+
+  // Copy rows without padding, flipping vertically
+  auto rowSize{static_cast<size_t>(image.width) *
+               formattedSurface->format->BytesPerPixel};
+  auto height{static_cast<size_t>(image.height)};
+  auto pitch{static_cast<size_t>(formattedSurface->pitch)};
+  gsl::span source{static_cast<const std::byte*>(formattedSurface->pixels),
+                   pitch * height};
+  image.pixels.resize(rowSize * height);
+  for (size_t row = 0; row < height; row++) {
+    memcpy(image.pixels.data() + rowSize * (height - row - 1),
+           source.subspan(pitch * row).data(), rowSize);
+  }
 
-    // Set texture filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  SDL_FreeSurface(formattedSurface);
 
-    // Generate the mipmap levels
-    if (generateMipmaps) {
-      glGenerateMipmap(GL_TEXTURE_2D);
+  return image;
+}
 
-      // Override minifying filtering
-      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                      GL_LINEAR_MIPMAP_LINEAR);
-    }
+/**
+ * @brief Creates a 2D texture from a decoded image.
+ *
+ * @param image Image decoded with abcg::loadImage.
+ * @param generateMipmaps Whether to generate mipmap levels.
+ * @return Name of the texture object.
+ */
+GLuint abcg::opengl::createTexture(const ImageData& image,
+                                   bool generateMipmaps) {
+  GLuint textureID{};
 
-    // Set texture wrapping
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-  } else {
-    throw abcg::Exception{abcg::Exception::Runtime(
-        fmt::format("Failed to load texture file {}", path))};
+  // Generate the texture
+  glGenTextures(1, &textureID);
+  glBindTexture(GL_TEXTURE_2D, textureID);
+
+  // Rows are tightly packed
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(image.format),
+               image.width, image.height, 0, image.format, GL_UNSIGNED_BYTE,
+               image.pixels.data());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  // Set texture filtering
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  // Generate the mipmap levels
+  if (generateMipmaps) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // Override minifying filtering
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    GL_LINEAR_MIPMAP_LINEAR);
   }
 
+  // Set texture wrapping
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
   glBindTexture(GL_TEXTURE_2D, 0);
 
   return textureID;
 }
 
+GLuint abcg::opengl::loadTexture(std::string_view path, bool generateMipmaps) {
+  return createTexture(loadImage(path), generateMipmaps);
+}
+
 GLuint abcg::opengl::loadCubemap(std::array<std::string_view, 6> paths,
                                  bool generateMipmaps) {
   GLuint textureID{};
@@ -10,9 +10,30 @@
 
 #include <abcg_external.hpp>
 #include <array>
+#include <cstddef>
 #include <string_view>
+#include <vector>
+
+namespace abcg {
+struct ImageData;
+[[nodiscard]] ImageData loadImage(std::string_view path);
+}  // namespace abcg
+
+/**
+ * @brief Decoded image, stored as tightly packed RGB or RGBA rows.
+ *
+ * Rows are stored bottom-up, as expected by glTexImage2D.
+ */
+struct abcg::ImageData {
+  int width{};
+  int height{};
+  GLenum format{};
+  std::vector<std::byte> pixels{};
+};
 
 namespace abcg::opengl {
+[[nodiscard]] GLuint createTexture(const ImageData& image,
+                                   bool generateMipmaps = true);
 [[nodiscard]] GLuint loadTexture(std::string_view path,
                                  bool generateMipmaps = true);
 [[nodiscard]] GLuint loadCubemap(std::array<std::string_view, 6> paths,
@@ -0,0 +1,226 @@
+/**
+ * @file abcg_meshcache.cpp
+ * @brief Definition of abcg::MeshCache class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_meshcache.hpp"
+
+#include <array>
+#include <filesystem>
+#include <span>
+#include <utility>
+
+#include "abcg_cachefile.hpp"
+
+namespace {
+using abcg::cachefile::fnv1a;
+using abcg::cachefile::fnv1aValue;
+
+// Bump whenever the layout of the cache file changes
+constexpr std::uint32_t cacheVersion{2};
+constexpr std::array<char, 8> cacheMagic{'A', 'B', 'C', 'G', 'M', 'S', 'H', 0};
+
+struct CacheHeader {
+  std::array<char, 8> magic{};
+  std::uint32_t version{};
+  std::uint32_t vertexSize{};
+  std::uint64_t sourceKey{};
+  std::uint64_t materialKey{};
+  std::uint64_t vertexCount{};
+  std::uint64_t indexCount{};
+  std::array<float, 13> material{};
+  std::uint32_t flags{};
+  std::uint32_t diffuseTexNameSize{};
+  std::uint32_t normalTexNameSize{};
+  std::uint32_t materialLibrariesSize{};
+};
+
+enum CacheFlags : std::uint32_t {
+  HasNormals = 1U << 0U,
+  HasTexCoords = 1U << 1U
+};
+
+// Material library names are stored one per line, as `mtllib` arguments
+// cannot contain line breaks
+std::string joinLines(const std::vector<std::string>& lines) {
+  std::string joined;
+  for (const auto& line : lines) {
+    joined += line;
+    joined += '\n';
+  }
+  return joined;
+}
+
+std::vector<std::string> splitLines(std::string_view joined) {
+  std::vector<std::string> lines;
+  while (!joined.empty()) {
+    const auto lineEnd{joined.find('\n')};
+    lines.emplace_back(joined.substr(0, lineEnd));
+    if (lineEnd == std::string_view::npos) break;
+    joined.remove_prefix(lineEnd + 1);
+  }
+  return lines;
+}
+}  // namespace
+
+/**
+ * @brief Constructs an abcg::MeshCache for a given source file.
+ *
+ * If the source file cannot be queried, the cache is disabled: read() always
+ * returns false and write() does nothing.
+ *
+ * @param sourcePath Path to the source mesh file (e.g., an OBJ file).
+ * @param options Loader options that affect the resulting mesh (e.g., whether
+ * the mesh is standardized). Different options yield different cache keys.
+ */
+abcg::MeshCache::MeshCache(std::string_view sourcePath, std::uint32_t options)
+    : m_cachePath{std::string{sourcePath} + ".cache"},
+      m_baseDirectory{
+          std::filesystem::path{sourcePath}.parent_path().string()} {
+  std::error_code error;
+  const auto lastWriteTime{std::filesystem::last_write_time(sourcePath, error)};
+  if (error) return;
+  const auto fileSize{std::filesystem::file_size(sourcePath, error)};
+  if (error) return;
+
+  auto key{fnv1a(sourcePath.data(), sourcePath.size())};
+  key = fnv1aValue(lastWriteTime.time_since_epoch().count(), key);
+  key = fnv1aValue(fileSize, key);
+  key = fnv1aValue(options, key);
+  m_sourceKey = (key == 0) ? 1 : key;
+}
+
+// Hashes the name, modification time and size of each material library. A
+// missing library also contributes to the key, so that creating it later
+// invalidates the cache
+std::uint64_t abcg::MeshCache::computeMaterialKey(
+    const std::vector<std::string>& materialLibraries) const {
+  auto key{fnv1aValue(materialLibraries.size(),
+                      abcg::cachefile::fnv1aOffsetBasis)};
+  for (const auto& library : materialLibraries) {
+    key = fnv1a(library.data(), library.size(), key);
+
+    const auto libraryPath{std::filesystem::path{m_baseDirectory} / library};
+    std::error_code error;
+    const auto lastWriteTime{
+        std::filesystem::last_write_time(libraryPath, error)};
+    const auto fileSize{error ? std::uintmax_t{}
+                              : std::filesystem::file_size(libraryPath, error)};
+    const auto found{!error};
+    key = fnv1aValue(found, key);
+    if (found) {
+      key = fnv1aValue(lastWriteTime.time_since_epoch().count(), key);
+      key = fnv1aValue(fileSize, key);
+    }
+  }
+  return key;
+}
+
+bool abcg::MeshCache::readRaw(std::size_t vertexSize,
+                              std::vector<std::byte>& vertexData,
+                              std::vector<GLuint>& indices,
+                              MeshCacheInfo& info) const {
+  if (m_sourceKey == 0 || vertexSize == 0) return false;
+
+  std::vector<std::byte> buffer;
+  if (!abcg::cachefile::readFile(m_cachePath, buffer)) return false;
+  const auto fileSize{buffer.size()};
+  if (fileSize < sizeof(CacheHeader)) return false;
+
+  CacheHeader header{};
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  if (header.magic != cacheMagic || header.version != cacheVersion ||
+      header.vertexSize != vertexSize || header.sourceKey != m_sourceKey) {
+    return false;
+  }
+
+  // Validate sizes before trusting the counts
+  const auto payloadSize{fileSize - sizeof(CacheHeader)};
+  if (header.vertexCount > payloadSize / vertexSize ||
+      header.indexCount > payloadSize / sizeof(GLuint)) {
+    return false;
+  }
+  const auto vertexDataSize{header.vertexCount * vertexSize};
+  const auto indexDataSize{header.indexCount * sizeof(GLuint)};
+  if (std::size_t{header.diffuseTexNameSize} + header.normalTexNameSize +
+          header.materialLibrariesSize + vertexDataSize + indexDataSize !=
+      payloadSize) {
+    return false;
+  }
+
+  auto offset{sizeof(CacheHeader)};
+  const auto* base{reinterpret_cast<const char*>(buffer.data())};
+
+  // Check the material libraries before trusting the cached materials
+  auto materialLibraries{
+      splitLines({base + offset, header.materialLibrariesSize})};
+  if (computeMaterialKey(materialLibraries) != header.materialKey) {
+    return false;
+  }
+  offset += header.materialLibrariesSize;
+
+  info.materialLibraries = std::move(materialLibraries);
+  info.diffuseTexName.assign(base + offset, header.diffuseTexNameSize);
+  offset += header.diffuseTexNameSize;
+  info.normalTexName.assign(base + offset, header.normalTexNameSize);
+  offset += header.normalTexNameSize;
+
+  vertexData.resize(vertexDataSize);
+  std::memcpy(vertexData.data(), base + offset, vertexDataSize);
+  offset += vertexDataSize;
+
+  indices.resize(header.indexCount);
+  std::memcpy(indices.data(), base + offset, indexDataSize);
+
+  const auto& material{header.material};
+  info.Ka = {material[0], material[1], material[2], material[3]};
+  info.Kd = {material[4], material[5], material[6], material[7]};
+  info.Ks = {material[8], material[9], material[10], material[11]};
+  info.shininess = material[12];
+  info.hasNormals = (header.flags & HasNormals) != 0U;
+  info.hasTexCoords = (header.flags & HasTexCoords) != 0U;
+
+  return true;
+}
+
+void abcg::MeshCache::writeRaw(std::size_t vertexSize,
+                               const std::byte* vertexData,
+                               std::size_t vertexDataSize,
+                               const std::vector<GLuint>& indices,
+                               const MeshCacheInfo& info) const {
+  if (m_sourceKey == 0 || vertexSize == 0) return;
+
+  CacheHeader header{};
+  header.magic = cacheMagic;
+  header.version = cacheVersion;
+  header.vertexSize = static_cast<std::uint32_t>(vertexSize);
+  header.sourceKey = m_sourceKey;
+  header.materialKey = computeMaterialKey(info.materialLibraries);
+  header.vertexCount = vertexDataSize / vertexSize;
+  header.indexCount = indices.size();
+  header.material = {info.Ka.r, info.Ka.g, info.Ka.b, info.Ka.a,
+                     info.Kd.r, info.Kd.g, info.Kd.b, info.Kd.a,
+                     info.Ks.r, info.Ks.g, info.Ks.b, info.Ks.a,
+                     info.shininess};
+  header.flags = (info.hasNormals ? HasNormals : 0U) |
+                 (info.hasTexCoords ? HasTexCoords : 0U);
+  header.diffuseTexNameSize =
+      static_cast<std::uint32_t>(info.diffuseTexName.size());
+  header.normalTexNameSize =
+      static_cast<std::uint32_t>(info.normalTexName.size());
+  const auto materialLibraries{joinLines(info.materialLibraries)};
+  header.materialLibrariesSize =
+      static_cast<std::uint32_t>(materialLibraries.size());
+
+  abcg::cachefile::writeFile(
+      m_cachePath,
+      {std::as_bytes(std::span{&header, 1}),
+       std::as_bytes(std::span{materialLibraries}),
+       std::as_bytes(std::span{info.diffuseTexName}),
+       std::as_bytes(std::span{info.normalTexName}),
+       std::span{vertexData, vertexDataSize},
+       std::as_bytes(std::span{indices})},
+      "mesh cache");
+}
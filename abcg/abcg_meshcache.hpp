@@ -0,0 +1,132 @@
+/**
+ * @file abcg_meshcache.hpp
+ * @brief abcg::MeshCache header file.
+ *
+ * Declaration of abcg::MeshCache class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_MESHCACHE_HPP_
+#define ABCG_MESHCACHE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <glm/vec4.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+class MeshCache;
+struct MeshCacheInfo;
+}  // namespace abcg
+
+/**
+ * @brief Material and attribute information stored along with a cached mesh.
+ *
+ */
+struct abcg::MeshCacheInfo {
+  glm::vec4 Ka{};
+  glm::vec4 Kd{};
+  glm::vec4 Ks{};
+  float shininess{};
+  std::string diffuseTexName{};
+  std::string normalTexName{};
+  // Files referenced by `mtllib`, relative to the directory of the mesh file
+  std::vector<std::string> materialLibraries{};
+  bool hasNormals{};
+  bool hasTexCoords{};
+};
+
+/**
+ * @brief abcg::MeshCache class.
+ *
+ * Binary cache of deduplicated vertex and index arrays of a mesh file.
+ *
+ * The cache file is stored next to the source file and is keyed on the
+ * source path, its modification time and size, the loader options and the
+ * size of the vertex type. The material libraries listed in MeshCacheInfo
+ * are stored along with the mesh, and their modification times and sizes
+ * are checked on read, so that editing a material file also invalidates the
+ * cache. Any mismatch is treated as a cache miss.
+ */
+class abcg::MeshCache {
+ public:
+  explicit MeshCache(std::string_view sourcePath, std::uint32_t options = 0);
+
+  template <typename T>
+  [[nodiscard]] bool read(std::vector<T>& vertices, std::vector<GLuint>& indices,
+                          MeshCacheInfo& info) const;
+  template <typename T>
+  void write(const std::vector<T>& vertices, const std::vector<GLuint>& indices,
+             const MeshCacheInfo& info) const;
+
+  [[nodiscard]] std::string getCachePath() const { return m_cachePath; }
+
+ private:
+  std::string m_cachePath{};
+  std::string m_baseDirectory{};
+  std::uint64_t m_sourceKey{};
+
+  [[nodiscard]] std::uint64_t computeMaterialKey(
+      const std::vector<std::string>& materialLibraries) const;
+
+  [[nodiscard]] bool readRaw(std::size_t vertexSize,
+                             std::vector<std::byte>& vertexData,
+                             std::vector<GLuint>& indices,
+                             MeshCacheInfo& info) const;
+  void writeRaw(std::size_t vertexSize, const std::byte* vertexData,
+                std::size_t vertexDataSize, const std::vector<GLuint>& indices,
+                const MeshCacheInfo& info) const;
+};
+
+/**
+ * @brief Reads the cached mesh, if it is valid.
+ *
+ * @tparam T Vertex type. Must be trivially copyable.
+ * @param vertices Vector that receives the cached vertices.
+ * @param indices Vector that receives the cached indices.
+ * @param info Structure that receives the cached material and attributes.
+ * @return true if the cache was valid and the output arguments were filled;
+ * false otherwise.
+ */
+template <typename T>
+bool abcg::MeshCache::read(std::vector<T>& vertices,
+                           std::vector<GLuint>& indices,
+                           MeshCacheInfo& info) const {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  std::vector<std::byte> vertexData;
+  if (!readRaw(sizeof(T), vertexData, indices, info)) return false;
+
+  vertices.resize(vertexData.size() / sizeof(T));
+  std::memcpy(vertices.data(), vertexData.data(), vertexData.size());
+  return true;
+}
+
+/**
+ * @brief Writes the mesh to the cache file.
+ *
+ * Failing to write the cache is not an error: a warning is printed and the
+ * cache is simply not used on the next load.
+ *
+ * @tparam T Vertex type. Must be trivially copyable.
+ * @param vertices Vertices to be cached.
+ * @param indices Indices to be cached.
+ * @param info Material and attributes to be cached.
+ */
+template <typename T>
+void abcg::MeshCache::write(const std::vector<T>& vertices,
+                            const std::vector<GLuint>& indices,
+                            const MeshCacheInfo& info) const {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  writeRaw(sizeof(T), reinterpret_cast<const std::byte*>(vertices.data()),
+           vertices.size() * sizeof(T), indices, info);
+}
+
+#endif
@@ -0,0 +1,722 @@
+/**
+ * @file abcg_objparser.cpp
+ * @brief Definition of the parallel Wavefront OBJ importer.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_objparser.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "abcg_exception.hpp"
+
+#if !defined(__EMSCRIPTEN__) && (defined(__unix__) || defined(__APPLE__))
+#define ABCG_OBJPARSER_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Chunks smaller than this are not worth a thread of their own
+constexpr std::size_t minChunkSize{1U << 20U};
+
+// Read-only view of a whole file. Uses a memory mapping where available and
+// falls back to a single bulk read otherwise.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+#if defined(ABCG_OBJPARSER_MMAP)
+    const int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+      throw abcg::Exception{
+          abcg::Exception::Runtime(fmt::format("Failed to open {}", path))};
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0) {
+      close(fd);
+      throw abcg::Exception{
+          abcg::Exception::Runtime(fmt::format("Failed to open {}", path))};
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size > 0) {
+      void *address{mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+      if (address == MAP_FAILED) {
+        close(fd);
+        throw abcg::Exception{
+            abcg::Exception::Runtime(fmt::format("Failed to map {}", path))};
+      }
+      madvise(address, m_size, MADV_SEQUENTIAL);
+      m_data = static_cast<const char *>(address);
+    }
+    close(fd);
+#else
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    if (!input) {
+      throw abcg::Exception{
+          abcg::Exception::Runtime(fmt::format("Failed to open {}", path))};
+    }
+    m_buffer.resize(static_cast<std::size_t>(input.tellg()));
+    input.seekg(0);
+    input.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+  }
+
+  ~MappedFile() {
+#if defined(ABCG_OBJPARSER_MMAP)
+    if (m_data != nullptr) {
+      munmap(const_cast<char *>(m_data), m_size);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile(MappedFile &&) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile &operator=(MappedFile &&) = delete;
+
+  [[nodiscard]] const char *data() const noexcept { return m_data; }
+  [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+ private:
+  const char *m_data{};
+  std::size_t m_size{};
+#if !defined(ABCG_OBJPARSER_MMAP)
+  std::vector<char> m_buffer;
+#endif
+};
+
+// Range of lines of the file and everything parsed from it. Positions,
+// normals and texture coordinates are numbered locally during the parallel
+// pass and rebased when the chunks are merged.
+struct Chunk {
+  const char *begin{};
+  const char *end{};
+
+  std::vector<tinyobj::real_t> vertices;
+  std::vector<tinyobj::real_t> normals;
+  std::vector<tinyobj::real_t> texcoords;
+  std::vector<tinyobj::index_t> corners;
+  std::vector<std::size_t> faceSizes;
+  // Positions in `corners` (corner * 3 + attribute) of relative indices
+  std::vector<std::size_t> relativeIndices;
+  // Number of positions, normals and texture coordinates in previous chunks
+  std::array<int, 3> bases{};
+  std::vector<std::vector<std::string>> mtllibs;
+
+  std::vector<tinyobj::index_t> triangles;
+
+  std::size_t numLines{};
+  std::size_t errorLine{};
+  std::string error;
+  std::exception_ptr exception;
+};
+
+bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+bool isNewLine(char c) { return c == '\r' || c == '\n' || c == '\0'; }
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+void skipSpaces(const char *&p, const char *end) {
+  while (p < end && isSpace(*p)) ++p;
+}
+
+// Equivalent to strcspn(p, " \t\r") on a bounded range, or to
+// strcspn(p, "/ \t\r") if stopAtSlash is true
+template <bool stopAtSlash = false>
+void skipToken(const char *&p, const char *end) {
+  while (p < end && !isSpace(*p) && !isNewLine(*p) &&
+         (!stopAtSlash || *p != '/')) {
+    ++p;
+  }
+}
+
+// Same algorithm as tinyobj's tryParseDouble, so that the parsed values are
+// bit-identical to those of tinyobj::ObjReader
+bool tryParseDouble(const char *s, const char *end, double &result) {
+  if (s >= end) return false;
+
+  double mantissa{};
+  int exponent{};
+  auto sign{'+'};
+  auto curr{s};
+  auto leadingDecimalDots{false};
+
+  if (*curr == '+' || *curr == '-') {
+    sign = *curr;
+    ++curr;
+    leadingDecimalDots = curr != end && *curr == '.';
+  } else if (*curr == '.') {
+    leadingDecimalDots = true;
+  } else if (!isDigit(*curr)) {
+    return false;
+  }
+
+  // Integer part
+  if (!leadingDecimalDots) {
+    int read{};
+    while (curr != end && isDigit(*curr)) {
+      mantissa *= 10;
+      mantissa += *curr - '0';
+      ++curr;
+      ++read;
+    }
+    if (read == 0) return false;
+  }
+
+  // Fractional part
+  if (curr != end && *curr == '.') {
+    ++curr;
+    int read{1};
+    while (curr != end && isDigit(*curr)) {
+      static constexpr std::array powLUT{
+          1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001};
+      mantissa += (*curr - '0') *
+                  (read < static_cast<int>(powLUT.size())
+                       ? powLUT.at(static_cast<std::size_t>(read))
+                       : std::pow(10.0, -read));
+      ++read;
+      ++curr;
+    }
+  }
+
+  // Exponent
+  if (curr != end && (*curr == 'e' || *curr == 'E')) {
+    ++curr;
+    auto expSign{'+'};
+    if (curr != end && (*curr == '+' || *curr == '-')) {
+      expSign = *curr;
+      ++curr;
+    } else if (curr == end || !isDigit(*curr)) {
+      return false;
+    }
+    int read{};
+    while (curr != end && isDigit(*curr)) {
+      exponent *= 10;
+      exponent += *curr - '0';
+      ++curr;
+      ++read;
+    }
+    exponent *= (expSign == '+' ? 1 : -1);
+    if (read == 0) return false;
+  }
+
+  result = (sign == '+' ? 1 : -1) *
+           (exponent != 0
+                ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent)
+                : mantissa);
+  return true;
+}
+
+tinyobj::real_t parseReal(const char *&p, const char *end) {
+  skipSpaces(p, end);
+  const auto *tokenEnd{p};
+  skipToken(tokenEnd, end);
+  double value{};
+  tryParseDouble(p, tokenEnd, value);
+  p = tokenEnd;
+  return static_cast<tinyobj::real_t>(value);
+}
+
+// Equivalent to atoi on a bounded range
+int parseInt(const char *p, const char *end) {
+  while (p < end && (isSpace(*p) || *p == '\r' || *p == '\v' || *p == '\f'))
+    ++p;
+  auto negative{false};
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    ++p;
+  }
+  long long value{};
+  while (p < end && isDigit(*p) && value <= std::numeric_limits<int>::max()) {
+    value = value * 10 + (*p - '0');
+    ++p;
+  }
+  return static_cast<int>(negative ? -value : value);
+}
+
+// Parses one of i, i/j, i//k or i/j/k. Relative (negative) indices are
+// resolved against the local count of the chunk and recorded for rebasing.
+bool parseCorner(const char *&p, const char *end, Chunk &chunk) {
+  const std::array localCounts{
+      static_cast<int>(chunk.vertices.size() / 3),
+      static_cast<int>(chunk.normals.size() / 3),
+      static_cast<int>(chunk.texcoords.size() / 2)};
+  tinyobj::index_t corner{-1, -1, -1};
+
+  auto parseIndex{[&](std::size_t attribute, int &index) {
+    const auto value{parseInt(p, end)};
+    if (value == 0) return false;
+    if (value > 0) {
+      index = value - 1;
+    } else {
+      index = localCounts.at(attribute) + value;
+      chunk.relativeIndices.push_back(chunk.corners.size() * 3 + attribute);
+    }
+    skipToken<true>(p, end);
+    return true;
+  }};
+
+  if (!parseIndex(0, corner.vertex_index)) return false;
+  if (p < end && *p == '/') {
+    ++p;
+    if (p < end && *p == '/') {
+      // i//k
+      ++p;
+      if (!parseIndex(1, corner.normal_index)) return false;
+    } else {
+      // i/j or i/j/k
+      if (!parseIndex(2, corner.texcoord_index)) return false;
+      if (p < end && *p == '/') {
+        ++p;
+        if (!parseIndex(1, corner.normal_index)) return false;
+      }
+    }
+  }
+
+  chunk.corners.push_back(corner);
+  return true;
+}
+
+// Splits the arguments of `mtllib` the same way tinyobj does
+std::vector<std::string> splitFilenames(std::string_view arguments) {
+  std::vector<std::string> filenames;
+  std::string token;
+  auto escaping{false};
+  for (const auto c : arguments) {
+    if (escaping) {
+      escaping = false;
+    } else if (c == '\\') {
+      escaping = true;
+      continue;
+    } else if (c == ' ') {
+      if (!token.empty()) filenames.push_back(token);
+      token.clear();
+      continue;
+    }
+    token += c;
+  }
+  filenames.push_back(token);
+  return filenames;
+}
+
+void parseChunk(Chunk &chunk) {
+  // Rough guess of the number of elements, to reduce reallocations
+  const auto estimate{static_cast<std::size_t>(chunk.end - chunk.begin) / 32};
+  chunk.vertices.reserve(estimate);
+  chunk.corners.reserve(estimate);
+
+  for (const auto *lineBegin{chunk.begin}; lineBegin < chunk.end;) {
+    const auto *lineEnd{static_cast<const char *>(
+        std::memchr(lineBegin, '\n',
+                    static_cast<std::size_t>(chunk.end - lineBegin)))};
+    if (lineEnd == nullptr) lineEnd = chunk.end;
+    const auto *next{lineEnd == chunk.end ? lineEnd : lineEnd + 1};
+    ++chunk.numLines;
+
+    // Trim '\r\n'
+    if (lineEnd > lineBegin && *(lineEnd - 1) == '\r') --lineEnd;
+
+    const auto *p{lineBegin};
+    const auto *end{lineEnd};
+    lineBegin = next;
+
+    skipSpaces(p, end);
+    if (p == end || *p == '#') continue;
+
+    const auto remaining{end - p};
+    if (p[0] == 'v' && remaining > 1 && isSpace(p[1])) {
+      // Position
+      p += 2;
+      for ([[maybe_unused]] auto i : {0, 1, 2}) {
+        chunk.vertices.push_back(parseReal(p, end));
+      }
+    } else if (p[0] == 'v' && remaining > 2 && p[1] == 'n' && isSpace(p[2])) {
+      // Normal
+      p += 3;
+      for ([[maybe_unused]] auto i : {0, 1, 2}) {
+        chunk.normals.push_back(parseReal(p, end));
+      }
+    } else if (p[0] == 'v' && remaining > 2 && p[1] == 't' && isSpace(p[2])) {
+      // Texture coordinates
+      p += 3;
+      for ([[maybe_unused]] auto i : {0, 1}) {
+        chunk.texcoords.push_back(parseReal(p, end));
+      }
+    } else if (p[0] == 'f' && remaining > 1 && isSpace(p[1])) {
+      // Face
+      p += 2;
+      skipSpaces(p, end);
+      std::size_t faceSize{};
+      while (p < end && !isNewLine(*p)) {
+        if (!parseCorner(p, end, chunk)) {
+          chunk.errorLine = chunk.numLines;
+          chunk.error = "zero value for face index";
+          return;
+        }
+        ++faceSize;
+        while (p < end && (isSpace(*p) || *p == '\r')) ++p;
+      }
+      chunk.faceSizes.push_back(faceSize);
+    } else if (remaining > 6 && std::string_view{p, 6} == "mtllib" &&
+               isSpace(p[6])) {
+      chunk.mtllibs.push_back(splitFilenames({p + 7, end}));
+    }
+  }
+}
+
+template <typename T>
+bool pointInTriangle(const T *x, const T *y, T testX, T testY) {
+  auto inside{false};
+  for (int i{}, j{2}; i < 3; j = i++) {
+    if (((y[i] > testY) != (y[j] > testY)) &&
+        (testX < (x[j] - x[i]) * (testY - y[i]) / (y[j] - y[i]) + x[i])) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+// Triangulates a polygon by ear clipping. Mirrors the triangulation of
+// tinyobj::ObjReader, including how it handles degenerate polygons, so that
+// both produce the same triangles.
+void triangulate(const tinyobj::index_t *face, std::size_t size,
+                 const std::vector<tinyobj::real_t> &v,
+                 std::vector<tinyobj::index_t> &triangles) {
+  using real_t = tinyobj::real_t;
+
+  if (size == 3) {
+    triangles.insert(triangles.end(), face, face + 3);
+    return;
+  }
+
+  auto outOfRange{[&](const tinyobj::index_t &index, std::size_t axis) {
+    return static_cast<std::size_t>(index.vertex_index) * 3 + axis >= v.size();
+  }};
+  auto coord{[&](const tinyobj::index_t &index, std::size_t axis) {
+    return v[static_cast<std::size_t>(index.vertex_index) * 3 + axis];
+  }};
+
+  // Find the two axes to work in
+  std::array<std::size_t, 2> axes{1, 2};
+  for (std::size_t k{}; k < size; ++k) {
+    const auto &i0{face[(k + 0) % size]};
+    const auto &i1{face[(k + 1) % size]};
+    const auto &i2{face[(k + 2) % size]};
+    if (outOfRange(i0, 2) || outOfRange(i1, 2) || outOfRange(i2, 2)) continue;
+
+    const real_t e0x{coord(i1, 0) - coord(i0, 0)};
+    const real_t e0y{coord(i1, 1) - coord(i0, 1)};
+    const real_t e0z{coord(i1, 2) - coord(i0, 2)};
+    const real_t e1x{coord(i2, 0) - coord(i1, 0)};
+    const real_t e1y{coord(i2, 1) - coord(i1, 1)};
+    const real_t e1z{coord(i2, 2) - coord(i1, 2)};
+    const real_t cx{std::fabs(e0y * e1z - e0z * e1y)};
+    const real_t cy{std::fabs(e0z * e1x - e0x * e1z)};
+    const real_t cz{std::fabs(e0x * e1y - e0y * e1x)};
+    const auto epsilon{std::numeric_limits<real_t>::epsilon()};
+    if (cx > epsilon || cy > epsilon || cz > epsilon) {
+      // Found a corner
+      if (!(cx > cy && cx > cz)) {
+        axes[0] = 0;
+        if (cz > cx && cz > cy) axes[1] = 1;
+      }
+      break;
+    }
+  }
+
+  real_t area{};
+  for (std::size_t k{}; k < size; ++k) {
+    const auto &i0{face[(k + 0) % size]};
+    const auto &i1{face[(k + 1) % size]};
+    if (outOfRange(i0, axes[0]) || outOfRange(i0, axes[1]) ||
+        outOfRange(i1, axes[0]) || outOfRange(i1, axes[1])) {
+      continue;
+    }
+    area += (coord(i0, axes[0]) * coord(i1, axes[1]) -
+             coord(i0, axes[1]) * coord(i1, axes[0])) *
+            static_cast<real_t>(0.5);
+  }
+
+  std::vector<tinyobj::index_t> remaining(face, face + size);
+  std::size_t guess{};
+  std::array<tinyobj::index_t, 3> ear{};
+  std::array<real_t, 3> x{};
+  std::array<real_t, 3> y{};
+
+  // Number of iterations that can be done without clipping an ear
+  auto remainingIterations{size};
+  auto previousSize{size};
+
+  while (remaining.size() > 3 && remainingIterations > 0) {
+    const auto polySize{remaining.size()};
+    if (guess >= polySize) guess -= polySize;
+
+    if (previousSize != polySize) {
+      previousSize = polySize;
+      remainingIterations = polySize;
+    } else {
+      --remainingIterations;
+    }
+
+    for (std::size_t k{}; k < 3; ++k) {
+      ear.at(k) = remaining[(guess + k) % polySize];
+      const auto invalid{outOfRange(ear.at(k), axes[0]) ||
+                         outOfRange(ear.at(k), axes[1])};
+      x.at(k) = invalid ? real_t{} : coord(ear.at(k), axes[0]);
+      y.at(k) = invalid ? real_t{} : coord(ear.at(k), axes[1]);
+    }
+
+    const real_t e0x{x[1] - x[0]};
+    const real_t e0y{y[1] - y[0]};
+    const real_t e1x{x[2] - x[1]};
+    const real_t e1y{y[2] - y[1]};
+    const real_t cross{e0x * e1y - e0y * e1x};
+    // Reflex vertex
+    if (cross * area < static_cast<real_t>(0.0)) {
+      ++guess;
+      continue;
+    }
+
+    // Check whether any other vertex is inside this triangle
+    auto overlap{false};
+    for (std::size_t other{3}; other < polySize; ++other) {
+      const auto &index{remaining[(guess + other) % polySize]};
+      if (outOfRange(index, axes[0]) || outOfRange(index, axes[1])) continue;
+      if (pointInTriangle(x.data(), y.data(), coord(index, axes[0]),
+                          coord(index, axes[1]))) {
+        overlap = true;
+        break;
+      }
+    }
+    if (overlap) {
+      ++guess;
+      continue;
+    }
+
+    // This triangle is an ear
+    triangles.insert(triangles.end(), ear.begin(), ear.end());
+    remaining.erase(remaining.begin() +
+                    static_cast<std::ptrdiff_t>((guess + 1) % polySize));
+  }
+
+  if (remaining.size() == 3) {
+    triangles.insert(triangles.end(), remaining.begin(), remaining.end());
+  }
+}
+
+// Rebases relative indices, validates all indices and triangulates the faces
+// of a chunk
+void finishChunk(Chunk &chunk, const abcg::ObjMesh &mesh) {
+  for (const auto position : chunk.relativeIndices) {
+    auto &corner{chunk.corners[position / 3]};
+    switch (position % 3) {
+      case 0:
+        corner.vertex_index += chunk.bases[0];
+        break;
+      case 1:
+        corner.normal_index += chunk.bases[1];
+        break;
+      default:
+        corner.texcoord_index += chunk.bases[2];
+        break;
+    }
+  }
+
+  const auto numVertices{static_cast<int>(mesh.vertices.size() / 3)};
+  const auto numNormals{static_cast<int>(mesh.normals.size() / 3)};
+  const auto numTexCoords{static_cast<int>(mesh.texcoords.size() / 2)};
+  for (const auto &corner : chunk.corners) {
+    if (corner.vertex_index < 0 || corner.vertex_index >= numVertices ||
+        corner.normal_index < -1 || corner.normal_index >= numNormals ||
+        corner.texcoord_index < -1 || corner.texcoord_index >= numTexCoords) {
+      chunk.error = "face index out of range";
+      return;
+    }
+  }
+
+  chunk.triangles.reserve(chunk.corners.size());
+  const auto *face{chunk.corners.data()};
+  for (const auto faceSize : chunk.faceSizes) {
+    // Faces must have 3+ vertices
+    if (faceSize >= 3) {
+      triangulate(face, faceSize, mesh.vertices, chunk.triangles);
+    }
+    face += faceSize;
+  }
+}
+
+// Runs task(chunk) for each chunk, using one thread per chunk
+template <typename Task>
+void forEachChunk(std::vector<Chunk> &chunks, Task task) {
+  auto run{[&](Chunk &chunk) {
+    try {
+      task(chunk);
+    } catch (...) {
+      chunk.exception = std::current_exception();
+    }
+  }};
+
+  std::vector<std::thread> threads;
+  threads.reserve(chunks.size() - 1);
+  for (std::size_t i{1}; i < chunks.size(); ++i) {
+    threads.emplace_back(run, std::ref(chunks[i]));
+  }
+  run(chunks.front());
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (const auto &chunk : chunks) {
+    if (chunk.exception) std::rethrow_exception(chunk.exception);
+  }
+}
+
+template <typename T, typename Member>
+void concatenate(std::vector<T> &output, std::vector<Chunk> &chunks,
+                 Member member) {
+  std::size_t total{};
+  for (const auto &chunk : chunks) total += (chunk.*member).size();
+  output.reserve(total);
+  for (auto &chunk : chunks) {
+    auto &part{chunk.*member};
+    output.insert(output.end(), part.begin(), part.end());
+    std::vector<T>{}.swap(part);
+  }
+}
+}  // namespace
+
+/**
+ * @brief Imports a Wavefront OBJ file using multiple threads.
+ *
+ * The file is memory-mapped and split into line-aligned chunks that are
+ * parsed in parallel. Positions (`v`), normals (`vn`), texture coordinates
+ * (`vt`) and faces (`f`) are supported, including relative face indices.
+ * Materials are read from the files given by `mtllib`, relative to the
+ * directory of the OBJ file. Other statements (e.g., `l`, `p`, `g`, `o`,
+ * `usemtl`) are ignored.
+ *
+ * The result is the same geometry that tinyobj::ObjReader produces, with the
+ * faces of all its shapes concatenated.
+ *
+ * @param path Path to the OBJ file.
+ * @param numThreads Maximum number of threads, including the calling one. If
+ * zero, uses the number of hardware threads. Callers that already run on a
+ * pool of worker threads (e.g., an abcg::AssetLoader job) should pass 1, so
+ * that concurrent imports do not oversubscribe the cores. Ignored in
+ * WebAssembly builds.
+ * @return Imported mesh.
+ *
+ * @throw abcg::Exception if the file cannot be read or contains invalid face
+ * indices.
+ */
+abcg::ObjMesh abcg::importObjFile(std::string_view path,
+                                  unsigned int numThreads) {
+  const MappedFile file{std::string{path}};
+
+#if defined(__EMSCRIPTEN__)
+  numThreads = 1;
+#else
+  if (numThreads == 0) {
+    numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+#endif
+  const auto numChunks{std::clamp<std::size_t>(file.size() / minChunkSize, 1,
+                                               numThreads)};
+
+  // Split the file into chunks that start at the beginning of a line
+  std::vector<Chunk> chunks(numChunks);
+  const auto *fileEnd{file.data() + file.size()};
+  for (std::size_t i{}; i < numChunks; ++i) {
+    auto &chunk{chunks[i]};
+    chunk.begin = (i == 0) ? file.data() : chunks[i - 1].end;
+    if (i + 1 == numChunks) {
+      chunk.end = fileEnd;
+      continue;
+    }
+    const auto *split{file.data() + file.size() * (i + 1) / numChunks};
+    split = std::max(split, chunk.begin);
+    const auto *newLine{static_cast<const char *>(
+        std::memchr(split, '\n', static_cast<std::size_t>(fileEnd - split)))};
+    chunk.end = (newLine == nullptr) ? fileEnd : newLine + 1;
+  }
+
+  forEachChunk(chunks, parseChunk);
+
+  std::size_t lineOffset{};
+  for (const auto &chunk : chunks) {
+    if (chunk.errorLine != 0) {
+      throw abcg::Exception{abcg::Exception::Runtime(
+          fmt::format("Failed to load model {} ({} at line {})", path,
+                      chunk.error, lineOffset + chunk.errorLine))};
+    }
+    lineOffset += chunk.numLines;
+  }
+
+  for (std::size_t i{1}; i < numChunks; ++i) {
+    const auto &previous{chunks[i - 1]};
+    chunks[i].bases = {
+        previous.bases[0] + static_cast<int>(previous.vertices.size() / 3),
+        previous.bases[1] + static_cast<int>(previous.normals.size() / 3),
+        previous.bases[2] + static_cast<int>(previous.texcoords.size() / 2)};
+  }
+
+  ObjMesh mesh;
+  concatenate(mesh.vertices, chunks, &Chunk::vertices);
+  concatenate(mesh.normals, chunks, &Chunk::normals);
+  concatenate(mesh.texcoords, chunks, &Chunk::texcoords);
+
+  forEachChunk(chunks, [&](Chunk &chunk) { finishChunk(chunk, mesh); });
+
+  for (const auto &chunk : chunks) {
+    if (!chunk.error.empty()) {
+      throw abcg::Exception{abcg::Exception::Runtime(
+          fmt::format("Failed to load model {} ({})", path, chunk.error))};
+    }
+  }
+
+  concatenate(mesh.indices, chunks, &Chunk::triangles);
+
+  // Load materials
+  const auto basePath{std::filesystem::path{path}.parent_path().string()};
+  tinyobj::MaterialFileReader materialReader{basePath};
+  std::map<std::string, int> materialMap;
+  std::string warning;
+  for (const auto &chunk : chunks) {
+    for (const auto &filenames : chunk.mtllibs) {
+      mesh.materialLibraries.insert(mesh.materialLibraries.end(),
+                                    filenames.begin(), filenames.end());
+      std::string error;
+      const auto found{std::any_of(
+          filenames.begin(), filenames.end(), [&](const auto &filename) {
+            return materialReader(filename, &mesh.materials, &materialMap,
+                                  &warning, &error);
+          })};
+      if (!found) {
+        warning += "Failed to load material file(s). Use default material.\n";
+      }
+    }
+  }
+  if (!warning.empty()) {
+    fmt::print("Warning: {}\n", warning);
+  }
+
+  return mesh;
+}
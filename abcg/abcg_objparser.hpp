@@ -0,0 +1,50 @@
+/**
+ * @file abcg_objparser.hpp
+ * @brief Header file of the parallel Wavefront OBJ importer.
+ *
+ * Declaration of abcg::ObjMesh and abcg::importObjFile.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OBJPARSER_HPP_
+#define ABCG_OBJPARSER_HPP_
+
+#include <string>
+#include <string_view>
+#include <tiny_obj_loader.h>
+#include <vector>
+
+namespace abcg {
+struct ObjMesh;
+[[nodiscard]] ObjMesh importObjFile(std::string_view path,
+                                    unsigned int numThreads = 0);
+}  // namespace abcg
+
+/**
+ * @brief Geometry and materials of a Wavefront OBJ file.
+ *
+ * The attribute arrays and indices follow the conventions of tinyobjloader:
+ * indices are zero-based, an index of -1 means that the attribute is absent,
+ * and polygons are triangulated the same way as tinyobj::ObjReader does.
+ * Faces of all groups and objects are concatenated in file order.
+ */
+struct abcg::ObjMesh {
+  /** @brief Vertex positions (x, y, z). */
+  std::vector<tinyobj::real_t> vertices;
+  /** @brief Vertex normals (x, y, z). */
+  std::vector<tinyobj::real_t> normals;
+  /** @brief Texture coordinates (u, v). */
+  std::vector<tinyobj::real_t> texcoords;
+  /** @brief Three indices per triangle. */
+  std::vector<tinyobj::index_t> indices;
+  /** @brief Materials of the files referenced by `mtllib`. */
+  std::vector<tinyobj::material_t> materials;
+  /**
+   * @brief Names of all files referenced by `mtllib`, relative to the
+   * directory of the OBJ file, whether they were found or not.
+   */
+  std::vector<std::string> materialLibraries;
+};
+
+#endif
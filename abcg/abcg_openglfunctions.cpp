@@ -7,10 +7,94 @@
 
 #include "abcg_openglfunctions.hpp"
 
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
 #include "abcg_exception.hpp"
 #include "abcg_external.hpp"
+#include "abcg_openglwindow.hpp"
 
 #if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+namespace {
+using sl = std::experimental::source_location;
+
+abcg::GLErrorCheck errorCheck{abcg::GLErrorCheck::PerCall};
+int errorCheckInterval{1};
+
+// Wrapped calls made since the last check in PerFrame and Sampled modes
+int uncheckedCalls{};
+sl firstUncheckedCall;
+sl lastUncheckedCall;
+
+// First error reported by the debug output callback and not yet thrown
+std::string debugOutputError;
+
+void GLAPIENTRY debugOutputCallback(GLenum /*source*/, GLenum type,
+                                    GLuint /*id*/, GLenum /*severity*/,
+                                    GLsizei length, const GLchar *message,
+                                    const void * /*userParam*/) {
+  // Exceptions must not propagate through the driver, so the error is thrown
+  // by the wrapper that made the call
+  if (type == GL_DEBUG_TYPE_ERROR && debugOutputError.empty()) {
+    debugOutputError.assign(message, static_cast<std::size_t>(length));
+  }
+}
+
+void throwDebugOutputError(const sl &sourceLocation, std::string_view prefix) {
+  const auto message{fmt::format("OpenGL error {} ({})", prefix,
+                                 std::exchange(debugOutputError, {}))};
+  throw abcg::Exception{abcg::Exception::Runtime(message, sourceLocation)};
+}
+
+void checkUncheckedCalls() {
+  uncheckedCalls = 0;
+  if (auto status{glGetError()}; status != GL_NO_ERROR) {
+    const auto prefix{fmt::format("AFTER calls since {}:{}:{}",
+                                  firstUncheckedCall.file_name(),
+                                  firstUncheckedCall.function_name(),
+                                  firstUncheckedCall.line())};
+    throw abcg::Exception{
+        abcg::Exception::OpenGL(prefix, status, lastUncheckedCall)};
+  }
+}
+}  // namespace
+
+/**
+ * @brief Sets how the OpenGL function wrappers check for errors.
+ *
+ * Must be called with a current OpenGL context. This is done by
+ * abcg::OpenGLWindow with the values of abcg::OpenGLSettings.
+ *
+ * @param mode Error checking mode.
+ * @param interval Number of calls between checks in GLErrorCheck::Sampled
+ * mode.
+ */
+void abcg::setGLErrorCheck(GLErrorCheck mode, int interval) {
+  if (mode == GLErrorCheck::DebugOutput) {
+    if (GLEW_VERSION_4_3 == GL_FALSE && GLEW_KHR_debug == GL_FALSE) {
+      fmt::print("KHR_debug is not supported. Checking errors per call.\n");
+      mode = GLErrorCheck::PerCall;
+    } else {
+      glEnable(GL_DEBUG_OUTPUT);
+      glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+      glDebugMessageCallback(debugOutputCallback, nullptr);
+      // Only errors are thrown, so disable all other messages
+      glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0,
+                            nullptr, GL_FALSE);
+      glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0,
+                            nullptr, GL_TRUE);
+    }
+  }
+
+  errorCheck = mode;
+  errorCheckInterval = std::max(interval, 1);
+  uncheckedCalls = 0;
+  debugOutputError.clear();
+}
+
 /**
  * @brief Checks OpenGL error status and throws on error with a log message.
  *
@@ -27,4 +111,80 @@ void abcg::checkGLError(
         abcg::Exception::OpenGL(prefix, status, sourceLocation)};
   }
 }
-#endif
\ No newline at end of file
+
+/**
+ * @brief Checks for errors of the calls made since the last check.
+ *
+ * Only has an effect in GLErrorCheck::PerFrame mode. Called by
+ * abcg::OpenGLWindow at the end of each frame.
+ *
+ * @param sourceLocation Location reported if no wrapped function was called
+ * since the last check.
+ *
+ * @throw abcg::Exception with a log message.
+ */
+void abcg::checkPendingGLErrors(
+    const std::experimental::source_location &sourceLocation) {
+  if (errorCheck != GLErrorCheck::PerFrame) return;
+  if (uncheckedCalls == 0) {
+    checkGLError(sourceLocation, "AT END OF FRAME");
+  } else {
+    checkUncheckedCalls();
+  }
+}
+
+/**
+ * @brief Checks for errors before a wrapped function call.
+ *
+ * Errors found here were caused by calls that are not wrapped.
+ *
+ * @param sourceLocation Information about the source code, used for logging.
+ *
+ * @throw abcg::Exception with a log message.
+ */
+void abcg::beforeGLCall(
+    const std::experimental::source_location &sourceLocation) {
+  switch (errorCheck) {
+    case GLErrorCheck::PerCall:
+      checkGLError(sourceLocation, "BEFORE function call");
+      break;
+    case GLErrorCheck::DebugOutput:
+      if (!debugOutputError.empty()) {
+        throwDebugOutputError(sourceLocation, "BEFORE function call");
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Checks for errors after a wrapped function call.
+ *
+ * @param sourceLocation Information about the source code, used for logging.
+ *
+ * @throw abcg::Exception with a log message.
+ */
+void abcg::afterGLCall(
+    const std::experimental::source_location &sourceLocation) {
+  switch (errorCheck) {
+    case GLErrorCheck::PerCall:
+      checkGLError(sourceLocation, "AFTER function call");
+      break;
+    case GLErrorCheck::PerFrame:
+    case GLErrorCheck::Sampled:
+      if (uncheckedCalls++ == 0) firstUncheckedCall = sourceLocation;
+      lastUncheckedCall = sourceLocation;
+      if (errorCheck == GLErrorCheck::Sampled &&
+          uncheckedCalls >= errorCheckInterval) {
+        checkUncheckedCalls();
+      }
+      break;
+    case GLErrorCheck::DebugOutput:
+      if (!debugOutputError.empty()) {
+        throwDebugOutputError(sourceLocation, "AFTER function call");
+      }
+      break;
+  }
+}
+#endif
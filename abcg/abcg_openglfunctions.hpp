@@ -3,7 +3,8 @@
  * @brief Declaration of OpenGL-related error checking functions.
  *
  * Error checking wrappers for OpenGL functions are defined here as inline
- * functions.
+ * functions. How often they check for errors is set with
+ * abcg::setGLErrorCheck (see abcg::GLErrorCheck).
  *
  * This project is released under the MIT License.
  */
@@ -18,14 +19,24 @@
 #include <string_view>
 
 #include "abcg_external.hpp"
+#include "abcg_glstatecache.hpp"
 
 namespace abcg {
+enum class GLErrorCheck;
+
 #if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+void setGLErrorCheck(GLErrorCheck mode, int interval);
 void checkGLError(const std::experimental::source_location& sourceLocation,
                   std::string_view prefix);
+void checkPendingGLErrors(
+    const std::experimental::source_location& sourceLocation =
+        std::experimental::source_location::current());
+void beforeGLCall(const std::experimental::source_location& sourceLocation);
+void afterGLCall(const std::experimental::source_location& sourceLocation);
 
 /**
- * @brief Check for OpenGL errors before and after a function call.
+ * @brief Call an OpenGL function and check for errors according to the
+ * current abcg::GLErrorCheck mode.
  *
  * @tparam TFun Function typename.
  * @tparam TArgs Variadic arguments typename.
@@ -37,24 +48,34 @@ void checkGLError(const std::experimental::source_location& sourceLocation,
 template <typename TFun, typename... TArgs>
 auto callGL(const std::experimental::source_location& sourceLocation,
             TFun&& function, TArgs&&... args) {
-  checkGLError(sourceLocation, "BEFORE function call");
+  beforeGLCall(sourceLocation);
   if constexpr (!std::is_void<
                     typename std::result_of<TFun(TArgs...)>::type>::value) {
     // Specialization for functions that do not return void
     auto&& res = std::forward<TFun>(function)(std::forward<TArgs>(args)...);
-    checkGLError(sourceLocation, "AFTER function call");
+    afterGLCall(sourceLocation);
     return res;
   }
   // Specialization for functions that return void
   std::forward<TFun>(function)(std::forward<TArgs>(args)...);
-  checkGLError(sourceLocation, "AFTER function call");
+  afterGLCall(sourceLocation);
 }
 
 using sl = std::experimental::source_location;
 
+// Functions that change state tracked by the state cache call the abcg::gl
+// entry point when ABCG_GL_STATE_CACHE is defined. Draw calls always do, so
+// that they are counted
+#if defined(ABCG_GL_STATE_CACHE)
+#define ABCG_GL_STATE(function, cached) gl::cached
+#else
+#define ABCG_GL_STATE(function, cached) ::function
+#endif
+
 inline void glActiveTexture(GLenum texture,
                             const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glActiveTexture, texture);
+  callGL(sourceLocation, ABCG_GL_STATE(glActiveTexture, activeTexture),
+         texture);
 }
 inline void glAttachShader(GLuint program, GLuint shader,
                            const sl& sourceLocation = sl::current()) {
@@ -62,11 +83,13 @@ inline void glAttachShader(GLuint program, GLuint shader,
 }
 inline void glBindBuffer(GLenum target, GLuint buffer,
                          const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glBindBuffer, target, buffer);
+  callGL(sourceLocation, ABCG_GL_STATE(glBindBuffer, bindBuffer), target,
+         buffer);
 }
 inline void glBindBufferBase(GLenum target, GLuint index, GLuint buffer,
                              const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glBindBufferBase, target, index, buffer);
+  callGL(sourceLocation, ABCG_GL_STATE(glBindBufferBase, bindBufferBase),
+         target, index, buffer);
 }
 inline void glBindFragDataLocation(GLuint program, GLuint colorNumber,
                                    const char* name,
@@ -83,11 +106,13 @@ inline void glBindRenderbuffer(GLenum target, GLuint renderbuffer,
 }
 inline void glBindTexture(GLenum target, GLuint texture,
                           const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glBindTexture, target, texture);
+  callGL(sourceLocation, ABCG_GL_STATE(glBindTexture, bindTexture), target,
+         texture);
 }
 inline void glBindVertexArray(GLuint array,
                               const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glBindVertexArray, array);
+  callGL(sourceLocation, ABCG_GL_STATE(glBindVertexArray, bindVertexArray),
+         array);
 }
 inline void glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1,
                               GLint srcY1, GLint dstX0, GLint dstY0,
@@ -97,11 +122,25 @@ inline void glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1,
   callGL(sourceLocation, ::glBlitFramebuffer, srcX0, srcY0, srcX1, srcY1, dstX0,
          dstY0, dstX1, dstY1, mask, filter);
 }
+inline void glBlendEquation(GLenum mode,
+                            const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glBlendEquation, blendEquation), mode);
+}
+inline void glBlendFunc(GLenum sfactor, GLenum dfactor,
+                        const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glBlendFunc, blendFunc), sfactor,
+         dfactor);
+}
 inline void glBufferData(GLenum target, GLsizeiptr size, const void* data,
                          GLenum usage,
                          const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glBufferData, target, size, data, usage);
 }
+inline void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
+                            const void* data,
+                            const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ::glBufferSubData, target, offset, size, data);
+}
 inline void glClear(GLbitfield mask, const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glClear, mask);
 }
@@ -125,9 +164,13 @@ inline void glCompileShader(GLuint shader,
                             const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glCompileShader, shader);
 }
+inline void glCullFace(GLenum mode, const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glCullFace, cullFace), mode);
+}
 inline void glDeleteBuffers(GLsizei n, const GLuint* buffers,
                             const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glDeleteBuffers, n, buffers);
+  callGL(sourceLocation, ABCG_GL_STATE(glDeleteBuffers, deleteBuffers), n,
+         buffers);
 }
 inline void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers,
                                  const sl& sourceLocation = sl::current()) {
@@ -147,11 +190,23 @@ inline void glDeleteShader(GLuint shader,
 }
 inline void glDeleteTextures(GLsizei n, const GLuint* textures,
                              const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glDeleteTextures, n, textures);
+  callGL(sourceLocation, ABCG_GL_STATE(glDeleteTextures, deleteTextures), n,
+         textures);
 }
 inline void glDeleteVertexArrays(GLsizei n, const GLuint* arrays,
                                  const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glDeleteVertexArrays, n, arrays);
+  callGL(sourceLocation,
+         ABCG_GL_STATE(glDeleteVertexArrays, deleteVertexArrays), n, arrays);
+}
+inline void glDepthFunc(GLenum func, const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glDepthFunc, depthFunc), func);
+}
+inline void glDepthMask(GLboolean flag,
+                        const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glDepthMask, depthMask), flag);
+}
+inline void glDisable(GLenum cap, const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glDisable, disable), cap);
 }
 inline void glDrawBuffers(GLsizei n, const GLenum* bufs,
                           const sl& sourceLocation = sl::current()) {
@@ -160,14 +215,20 @@ inline void glDrawBuffers(GLsizei n, const GLenum* bufs,
 inline void glDrawElements(GLenum mode, GLsizei count, GLenum type,
                            const void* indices,
                            const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glDrawElements, mode, count, type, indices);
+  callGL(sourceLocation, gl::drawElements, mode, count, type, indices);
+}
+inline void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type,
+                                    const void* indices, GLsizei instancecount,
+                                    const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, gl::drawElementsInstanced, mode, count, type, indices,
+         instancecount);
 }
 inline void glDrawArrays(GLenum mode, GLint first, GLsizei count,
                          const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glDrawArrays, mode, first, count);
+  callGL(sourceLocation, gl::drawArrays, mode, first, count);
 }
 inline void glEnable(GLenum cap, const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glEnable, cap);
+  callGL(sourceLocation, ABCG_GL_STATE(glEnable, enable), cap);
 }
 inline void glEnableVertexAttribArray(
     GLuint index, const sl& sourceLocation = sl::current()) {
@@ -185,6 +246,9 @@ inline void glFramebufferTexture(GLenum target, GLenum attachment,
   callGL(sourceLocation, ::glFramebufferTexture, target, attachment, texture,
          level);
 }
+inline void glFrontFace(GLenum mode, const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ABCG_GL_STATE(glFrontFace, frontFace), mode);
+}
 inline void glGenerateMipmap(GLenum target,
                              const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glGenerateMipmap, target);
@@ -209,6 +273,20 @@ inline void glGenVertexArrays(GLsizei n, GLuint* arrays,
                               const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glGenVertexArrays, n, arrays);
 }
+inline void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize,
+                              GLsizei* length, GLint* size, GLenum* type,
+                              GLchar* name,
+                              const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ::glGetActiveAttrib, program, index, bufSize, length,
+         size, type, name);
+}
+inline void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize,
+                               GLsizei* length, GLint* size, GLenum* type,
+                               GLchar* name,
+                               const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ::glGetActiveUniform, program, index, bufSize, length,
+         size, type, name);
+}
 inline GLint glGetAttribLocation(GLuint program, const GLchar* name,
                                  const sl& sourceLocation = sl::current()) {
   return callGL(sourceLocation, ::glGetAttribLocation, program, name);
@@ -293,10 +371,18 @@ inline void glUniform1i(GLint location, GLint v0,
                         const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glUniform1i, location, v0);
 }
+inline void glUniform2fv(GLint location, GLsizei count, const GLfloat* value,
+                         const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ::glUniform2fv, location, count, value);
+}
 inline void glUniform3fv(GLint location, GLsizei count, const GLfloat* value,
                          const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glUniform3fv, location, count, value);
 }
+inline void glUniform4fv(GLint location, GLsizei count, const GLfloat* value,
+                         const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ::glUniform4fv, location, count, value);
+}
 inline void glUniformMatrix3fv(GLint location, GLsizei count,
                                GLboolean transpose, const GLfloat* value,
                                const sl& sourceLocation = sl::current()) {
@@ -317,7 +403,11 @@ inline void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex,
 }
 inline void glUseProgram(GLuint program,
                          const sl& sourceLocation = sl::current()) {
-  callGL(sourceLocation, ::glUseProgram, program);
+  callGL(sourceLocation, ABCG_GL_STATE(glUseProgram, useProgram), program);
+}
+inline void glVertexAttribDivisor(GLuint index, GLuint divisor,
+                                  const sl& sourceLocation = sl::current()) {
+  callGL(sourceLocation, ::glVertexAttribDivisor, index, divisor);
 }
 inline void glVertexAttribPointer(GLuint index, GLint size, GLenum type,
                                   GLboolean normalized, GLsizei stride,
@@ -330,7 +420,18 @@ inline void glViewport(GLint x, GLint y, GLsizei width, GLsizei height,
                        const sl& sourceLocation = sl::current()) {
   callGL(sourceLocation, ::glViewport, x, y, width, height);
 }
+#undef ABCG_GL_STATE
 #endif
 }  // namespace abcg
 
+#endif
+
+// Without the error checking wrappers, calls from abcg go directly to the
+// abcg::gl entry points
+#if defined(NDEBUG) || defined(__EMSCRIPTEN__) || defined(__APPLE__)
+#define ABCG_GL_DRAW_REDIRECT
+#if defined(ABCG_GL_STATE_CACHE)
+#define ABCG_GL_STATE_CACHE_REDIRECT
+#endif
+#include "abcg_glstatecache.hpp"
 #endif
\ No newline at end of file
@@ -13,41 +13,28 @@
 #include <imgui_impl_sdl.h>
 
 #include <algorithm>
+#include <cppitertools/itertools.hpp>
 #include <fstream>
 #include <regex>
 #include <sstream>
 #include <string_view>
+#include <vector>
 
 #include "SDL_events.h"
+#include "SDL_image.h"
 #include "SDL_video.h"
 #include "abcg_application.hpp"
 #include "abcg_embeddedfonts.hpp"
 #include "abcg_openglfunctions.hpp"
 #include "abcg_string.hpp"
+#include "abcg_tracer.hpp"
 
-void printShaderInfoLog(GLuint shader, std::string_view prefix) {
-  GLint infoLogLength{};
-  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
-
-  if (infoLogLength > 0) {
-    std::vector<GLchar> infoLog{};
-    infoLog.reserve(static_cast<size_t>(infoLogLength));
-    glGetShaderInfoLog(shader, infoLogLength, nullptr, infoLog.data());
-    fmt::print("{} information log:\n{}\n", prefix, infoLog.data());
-  }
-}
-
-void printProgramInfoLog(GLuint program) {
-  GLint infoLogLength{};
-  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-
-  if (infoLogLength > 0) {
-    std::vector<GLchar> infoLog{};
-    infoLog.reserve(static_cast<size_t>(infoLogLength));
-    glGetProgramInfoLog(program, infoLogLength, nullptr, infoLog.data());
-    fmt::print("Program information log:\n{}\n", infoLog.data());
-  }
-}
+#if defined(ABCG_GL_STATE_CACHE)
+namespace {
+// Context whose state is shadowed by the OpenGL state cache
+SDL_GLContext stateCacheContext{};
+}  // namespace
+#endif
 
 ImVec4 ColorAlpha(const ImVec4 &color, float alpha) {
   return ImVec4(color.x, color.y, color.z, alpha);
@@ -171,6 +158,10 @@ abcg::OpenGLWindow::~OpenGLWindow() {
       ImGui::DestroyContext();
     }
 
+    // Release the queries while the context exists
+    m_benchmarkRecorder.reset();
+    m_gpuProfiler.reset();
+
     if (m_GLContext != nullptr) {
       SDL_GL_DeleteContext(m_GLContext);
     }
@@ -237,6 +228,57 @@ void abcg::OpenGLWindow::paintUI() {
                      static_cast<int>(offset), label.c_str(), 0.0f,
                      *std::max_element(frames.begin(), frames.end()) * 2,
                      ImVec2(static_cast<float>(frames.size()), 50));
+#if defined(ABCG_GL_STATE_CACHE)
+    ImGui::Text("GL state: %zu issued, %zu elided", m_glStateCounters.issued,
+                m_glStateCounters.elided);
+#endif
+    ImGui::Text("GL draws: %zu", m_glStateCounters.draws);
+    ImGui::End();
+  }
+
+  // GPU time of the zones of paintGL, shown only if paintGL has zones
+  if (m_windowSettings.showFPS && m_gpuProfiler &&
+      m_gpuProfiler->getResults().size() > 1) {
+    const auto &results{m_gpuProfiler->getResults()};
+
+    ImGui::SetNextWindowPos(ImVec2(5, 90), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("GPU zones", nullptr,
+                     ImGuiWindowFlags_AlwaysAutoResize)) {
+
+      // Flame graph: one row per nesting level, scaled to the paintGL zone
+      const auto &root{results.front()};
+      const auto width{300.0f};
+      const auto scale{
+          width / static_cast<float>(
+                      std::max(root.startMs + root.durationMs, 1e-3))};
+      const auto rowHeight{ImGui::GetTextLineHeightWithSpacing()};
+      const auto origin{ImGui::GetCursorScreenPos()};
+      auto *drawList{ImGui::GetWindowDrawList()};
+      auto maxDepth{0};
+      for (const auto &result : results) {
+        const ImVec2 min{
+            origin.x + static_cast<float>(result.startMs) * scale,
+            origin.y + static_cast<float>(result.depth) * rowHeight};
+        const auto length{static_cast<float>(result.durationMs) * scale};
+        const ImVec2 max{min.x + std::max(length, 1.0f),
+                         min.y + rowHeight - 1.0f};
+        const auto hue{0.6f - 0.12f * static_cast<float>(result.depth)};
+        drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.6f, 0.7f));
+        drawList->PushClipRect(min, max, true);
+        drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32_WHITE,
+                          result.name.c_str());
+        drawList->PopClipRect();
+        maxDepth = std::max(maxDepth, result.depth);
+      }
+      ImGui::Dummy(
+          ImVec2(width, static_cast<float>(maxDepth + 1) * rowHeight));
+
+      for (const auto &result : results) {
+        ImGui::Text("%*s%s: %.3f ms", result.depth * 2, "", result.name.c_str(),
+                    result.durationMs);
+      }
+    }
     ImGui::End();
   }
 
@@ -282,7 +324,37 @@ void abcg::OpenGLWindow::resizeGL(int width, int height) {
 
 void abcg::OpenGLWindow::terminateGL() {}
 
-GLuint abcg::OpenGLWindow::createProgramFromFile(
+/**
+ * @brief Compiles and links a program from the files of its shaders.
+ *
+ * Same as createProgramFromFileAsync() followed by ProgramFuture::get().
+ *
+ * @param pathToVertexShader Path to the vertex shader file.
+ * @param pathToFragmentShader Path to the fragment shader file.
+ * @return Handle to the linked program.
+ *
+ * @throw abcg::Exception if a file cannot be read, a shader fails to compile
+ * or the program fails to link.
+ */
+abcg::ShaderProgram abcg::OpenGLWindow::createProgramFromFile(
+    std::string_view pathToVertexShader,
+    std::string_view pathToFragmentShader) {
+  return createProgramFromFileAsync(pathToVertexShader, pathToFragmentShader)
+      .get();
+}
+
+/**
+ * @brief Submits the build of a program from the files of its shaders.
+ *
+ * The files are read immediately. See createProgramFromStringAsync().
+ *
+ * @param pathToVertexShader Path to the vertex shader file.
+ * @param pathToFragmentShader Path to the fragment shader file.
+ * @return Future of the program.
+ *
+ * @throw abcg::Exception if a file cannot be read.
+ */
+abcg::ProgramFuture abcg::OpenGLWindow::createProgramFromFileAsync(
     std::string_view pathToVertexShader,
     std::string_view pathToFragmentShader) {
   std::stringstream vertexShaderSource;
@@ -303,13 +375,58 @@ GLuint abcg::OpenGLWindow::createProgramFromFile(
         "Failed to read fragment shader file {}", pathToFragmentShader))};
   }
 
-  return createProgramFromString(vertexShaderSource.str(),
-                                 fragmentShaderSource.str());
+  return createProgramFromStringAsync(vertexShaderSource.str(),
+                                      fragmentShaderSource.str());
 }
 
-GLuint abcg::OpenGLWindow::createProgramFromString(
+/**
+ * @brief Compiles and links a program from the sources of its shaders.
+ *
+ * Same as createProgramFromStringAsync() followed by ProgramFuture::get().
+ *
+ * @param vertexShaderSource Source of the vertex shader.
+ * @param fragmentShaderSource Source of the fragment shader.
+ * @param transformFeedbackVaryings Names of the vertex shader outputs
+ * captured in interleaved mode during transform feedback, if any.
+ * @return Handle to the linked program.
+ *
+ * @throw abcg::Exception if a shader fails to compile or the program fails
+ * to link.
+ */
+abcg::ShaderProgram abcg::OpenGLWindow::createProgramFromString(
     std::string_view vertexShaderSource,
-    std::string_view fragmentShaderSource) {
+    std::string_view fragmentShaderSource,
+    std::span<const char *const> transformFeedbackVaryings) {
+  return createProgramFromStringAsync(vertexShaderSource, fragmentShaderSource,
+                                      transformFeedbackVaryings)
+      .get();
+}
+
+/**
+ * @brief Submits the build of a program from the sources of its shaders.
+ *
+ * Both shaders are compiled and the program is linked, but no status is
+ * queried, so the call returns without waiting for the driver. Errors are
+ * reported by ProgramFuture::get(). Submitting all programs before resolving
+ * any of them lets the driver build them in parallel if it supports
+ * KHR_parallel_shader_compile.
+ *
+ * If the program cache is enabled (see OpenGLSettings::programCache), the
+ * program is loaded from the binary stored by a previous run with the same
+ * sources and driver, and is only compiled and linked if there is no such
+ * binary or the driver rejects it. The returned future is then already
+ * resolved.
+ *
+ * @param vertexShaderSource Source of the vertex shader.
+ * @param fragmentShaderSource Source of the fragment shader.
+ * @param transformFeedbackVaryings Names of the vertex shader outputs
+ * captured in interleaved mode during transform feedback, if any.
+ * @return Future of the program.
+ */
+abcg::ProgramFuture abcg::OpenGLWindow::createProgramFromStringAsync(
+    std::string_view vertexShaderSource,
+    std::string_view fragmentShaderSource,
+    std::span<const char *const> transformFeedbackVaryings) {
   using namespace std::string_literals;
 
   std::string vsSource{abcg::trimCopy(std::string{vertexShaderSource})};
@@ -350,48 +467,73 @@ GLuint abcg::OpenGLWindow::createProgramFromString(
   }
 #endif
 
-  GLint compileStatus{};
+  // Try the binary built by a previous run. The GLSL version header is part
+  // of the key because sources that have their own #version keep it
+  std::uint64_t cacheKey{};
+  if (m_programCache) {
+    std::vector<std::string_view> keyParts{vsSource, fsSource, m_GLSLVersion};
+    keyParts.insert(keyParts.end(), transformFeedbackVaryings.begin(),
+                    transformFeedbackVaryings.end());
+    cacheKey = m_programCache->computeKey(keyParts);
+
+    GLuint cachedProgram = glCreateProgram();
+    if (m_programCache->load(cachedProgram, cacheKey)) {
+      return ProgramFuture{cachedProgram};
+    }
+    glDeleteProgram(cachedProgram);
+  }
+
+  // Status queries block until the driver finishes, so they are left to
+  // ProgramFuture::get()
   GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
   const char *vsSourceConstChar = vsSource.c_str();
   glShaderSource(vertexShader, 1, &vsSourceConstChar, nullptr);
   glCompileShader(vertexShader);
-  glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &compileStatus);
-  if (compileStatus == 0) {
-    printShaderInfoLog(vertexShader, "Vertex shader");
-    throw abcg::Exception{
-        abcg::Exception::Runtime("Failed to compile vertex shader")};
-  }
 
   GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
   const char *fsSourceConstChar = fsSource.c_str();
   glShaderSource(fragmentShader, 1, &fsSourceConstChar, nullptr);
   glCompileShader(fragmentShader);
-  glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &compileStatus);
-  if (compileStatus == 0) {
-    printShaderInfoLog(fragmentShader, "Fragment shader");
-    glDeleteShader(vertexShader);
-    throw abcg::Exception{
-        abcg::Exception::Runtime("Failed to compile fragment shader")};
-  }
 
   GLuint shaderProgram = glCreateProgram();
   glAttachShader(shaderProgram, vertexShader);
   glAttachShader(shaderProgram, fragmentShader);
 
-  glLinkProgram(shaderProgram);
-  GLint linkStatus{};
-  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linkStatus);
-  if (linkStatus == 0) {
-    printProgramInfoLog(shaderProgram);
-    glDeleteShader(fragmentShader);
-    glDeleteShader(vertexShader);
-    throw abcg::Exception{abcg::Exception::Runtime("Failed to link program")};
+  // Must be set before linking
+  if (!transformFeedbackVaryings.empty()) {
+    glTransformFeedbackVaryings(
+        shaderProgram, static_cast<GLsizei>(transformFeedbackVaryings.size()),
+        transformFeedbackVaryings.data(), GL_INTERLEAVED_ATTRIBS);
   }
 
-  glDeleteShader(fragmentShader);
-  glDeleteShader(vertexShader);
+  // Some drivers only return the binary if this hint is set before linking
+  if (m_programCache) {
+    glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                        GL_TRUE);
+  }
+
+  // Linking shaders that failed to compile is not an error by itself: the
+  // link fails, and get() reports the compile error first
+  glLinkProgram(shaderProgram);
 
-  return shaderProgram;
+  return ProgramFuture{shaderProgram, vertexShader, fragmentShader,
+                       m_programCache.get(), cacheKey};
+}
+
+/**
+ * @brief Returns the asynchronous asset loader of this window.
+ *
+ * The loader and its worker threads are created on first use. Upload stages
+ * of finished loads are executed at the beginning of each frame, before
+ * paintUI() and paintGL().
+ *
+ * @return Reference to the asset loader.
+ */
+abcg::AssetLoader &abcg::OpenGLWindow::getAssetLoader() {
+  if (!m_assetLoader) {
+    m_assetLoader = std::make_unique<AssetLoader>();
+  }
+  return *m_assetLoader;
 }
 
 std::string abcg::OpenGLWindow::getAssetsPath() { return m_assetsPath; }
@@ -399,9 +541,25 @@ std::string abcg::OpenGLWindow::getAssetsPath() { return m_assetsPath; }
 double abcg::OpenGLWindow::getDeltaTime() const { return m_lastDeltaTime; }
 
 double abcg::OpenGLWindow::getElapsedTime() const {
+  if (m_fixedDeltaTime > 0.0) return m_fixedElapsedTime;
   return m_windowStartTime.elapsed();
 }
 
+/**
+ * @brief Sets whether the window content changes without user input.
+ *
+ * Windows are animating by default. If OpenGLSettings::idleMode is set and no
+ * window is animating, the main loop paints only after events or after an
+ * idle timeout, instead of painting continuously.
+ *
+ * @param animating True if the window must be painted continuously.
+ */
+void abcg::OpenGLWindow::setAnimating(bool animating) {
+  // Do not count the time spent idle as the delta time of the next frame
+  if (animating && !m_animating) m_deltaTime.restart();
+  m_animating = animating;
+}
+
 void abcg::OpenGLWindow::toggleFullscreen() {
 #if defined(__EMSCRIPTEN__)
   EM_ASM(toggleFullscreen(););
@@ -539,16 +697,25 @@ void abcg::OpenGLWindow::initialize(std::string_view basePath) {
   m_GLSLVersion +=
       fmt::format("#version {:d}{:02d}", majorVersion, minorVersion * 10);
 
+  // Debug output is only guaranteed to be enabled in debug contexts
+  int debugContextFlag{};
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  if (m_openGLSettings.errorCheck == GLErrorCheck::DebugOutput) {
+    debugContextFlag = SDL_GL_CONTEXT_DEBUG_FLAG;
+  }
+#endif
+
   switch (profile) {
     case OpenGLProfile::Core:
-      SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
-                          SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+      SDL_GL_SetAttribute(
+          SDL_GL_CONTEXT_FLAGS,
+          SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG | debugContextFlag);
       SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
                           SDL_GL_CONTEXT_PROFILE_CORE);
       m_GLSLVersion += " core";
       break;
     case OpenGLProfile::Compatibility:
-      SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+      SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, debugContextFlag);
       SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
                           SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
       m_GLSLVersion += " compatibility";
@@ -556,7 +723,7 @@ void abcg::OpenGLWindow::initialize(std::string_view basePath) {
     case OpenGLProfile::ES:
       majorVersion = 3;
       minorVersion = 0;
-      SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+      SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, debugContextFlag);
       SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
                           SDL_GL_CONTEXT_PROFILE_ES);
       m_GLSLVersion = "#version 300 es";
@@ -578,10 +745,12 @@ void abcg::OpenGLWindow::initialize(std::string_view basePath) {
   }
 
   // Create window with graphics context
+  Uint32 windowFlags{SDL_WINDOW_OPENGL};
+  windowFlags |= m_headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE;
   m_window = SDL_CreateWindow(m_windowSettings.title.c_str(),
                               SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
                               m_windowSettings.width, m_windowSettings.height,
-                              SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+                              windowFlags);
   if (m_window == nullptr) {
     throw abcg::Exception{abcg::Exception::SDL("SDL_CreateWindow failed")};
   }
@@ -603,7 +772,9 @@ void abcg::OpenGLWindow::initialize(std::string_view basePath) {
 #endif
 
 #if !defined(__EMSCRIPTEN__)
-  if (GLenum err{glewInit()}; GLEW_OK != err) {
+  // glewInit also initializes GLX, which requires a display
+  if (GLenum err{m_headless ? glewContextInit() : glewInit()};
+      GLEW_OK != err) {
     std::string header{"Failed to initialize OpenGL loader: "};
     const auto *const message{
         reinterpret_cast<const char *>(glewGetErrorString(err))};
@@ -612,6 +783,34 @@ void abcg::OpenGLWindow::initialize(std::string_view basePath) {
   fmt::print("Using GLEW.....: {}\n", glewGetString(GLEW_VERSION));
 #endif
 
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  setGLErrorCheck(m_openGLSettings.errorCheck,
+                  m_openGLSettings.errorCheckInterval);
+#endif
+
+  if (GpuProfiler::isSupported()) {
+    m_gpuProfiler = std::make_unique<GpuProfiler>();
+  }
+
+#if !defined(__EMSCRIPTEN__)
+  // Let the driver choose how many threads compile shaders in the background
+  if (GLEW_KHR_parallel_shader_compile != GL_FALSE) {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+  } else if (GLEW_ARB_parallel_shader_compile != GL_FALSE) {
+    glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+  }
+#endif
+
+  if (m_openGLSettings.programCache && ProgramCache::isSupported()) {
+    m_programCache = std::make_unique<ProgramCache>(std::string(basePath) +
+                                                    "/programcache/");
+  }
+
+#if defined(ABCG_GL_STATE_CACHE)
+  gl::invalidateStateCache();
+  stateCacheContext = m_GLContext;
+#endif
+
   fmt::print("OpenGL vendor..: {}\n", glGetString(GL_VENDOR));
   fmt::print("OpenGL renderer: {}\n", glGetString(GL_RENDERER));
   fmt::print("OpenGL version.: {}\n", glGetString(GL_VERSION));
@@ -662,9 +861,26 @@ void abcg::OpenGLWindow::initialize(std::string_view basePath) {
   }
 }
 
+// Returns true if the main loop may wait for events before painting
+bool abcg::OpenGLWindow::isIdle() const {
+  return m_openGLSettings.idleMode && !m_animating &&
+         (!m_assetLoader || m_assetLoader->getPendingCount() == 0);
+}
+
 void abcg::OpenGLWindow::paint() {
   SDL_GL_MakeCurrent(m_window, m_GLContext);
 
+#if defined(ABCG_GL_STATE_CACHE)
+  if (stateCacheContext != m_GLContext) {
+    gl::invalidateStateCache();
+    stateCacheContext = m_GLContext;
+  }
+#endif
+  // Draw calls are counted even without the state cache
+  gl::resetStateCacheCounters();
+
+  if (m_benchmarkRecorder) m_benchmarkRecorder->beginFrame();
+
 #if defined(__EMSCRIPTEN__)
   // Force window size in windowed mode
   EmscriptenFullscreenChangeEvent fullscreenStatus{};
@@ -675,18 +891,113 @@ void abcg::OpenGLWindow::paint() {
   }
 #endif
 
+  // Upload assets that finished loading in the background
+  if (m_assetLoader) {
+    ABCG_TRACE_SCOPE("processUploads");
+    m_assetLoader->processUploads();
+  }
+
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplSDL2_NewFrame(m_window);
   ImGui::NewFrame();
-  paintUI();
-  ImGui::Render();
-  paintGL();
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-  SDL_GL_SwapWindow(m_window);
+  {
+    ABCG_TRACE_SCOPE("paintUI");
+    paintUI();
+  }
+  {
+    ABCG_TRACE_SCOPE("ImGui::Render");
+    ImGui::Render();
+  }
+  if (m_gpuProfiler) {
+    m_gpuProfiler->beginFrame();
+    m_gpuProfiler->pushZone("paintGL");
+    GpuProfiler::setCurrent(m_gpuProfiler.get());
+  }
+  {
+    ABCG_TRACE_SCOPE("paintGL");
+    paintGL();
+  }
+  if (m_gpuProfiler) {
+    GpuProfiler::setCurrent(nullptr);
+    m_gpuProfiler->endFrame();
+  }
+  m_glStateCounters = gl::getStateCacheCounters();
+  // The ImGui renderer restores the OpenGL state it changes, so the state
+  // cache remains valid
+  if (!m_headless) {
+    ABCG_TRACE_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  }
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  checkPendingGLErrors();
+#endif
+  if (m_benchmarkRecorder) {
+    m_benchmarkRecorder->endFrame(m_glStateCounters.draws);
+  }
+  if (!m_capturePath.empty()) {
+    saveFrame(m_capturePath);
+    m_capturePath.clear();
+  }
+  {
+    ABCG_TRACE_SCOPE("SDL_GL_SwapWindow");
+    SDL_GL_SwapWindow(m_window);
+  }
+
+  if (m_fixedDeltaTime > 0.0) {
+    m_lastDeltaTime = m_fixedDeltaTime;
+    m_fixedElapsedTime += m_fixedDeltaTime;
+    return;
+  }
 
   // Cap to 480 Hz
   if (m_deltaTime.elapsed() >= 1.0 / 480.0) {
     m_lastDeltaTime = m_deltaTime.restart();
   } else
     m_lastDeltaTime = 0.0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Saves the default framebuffer to a PNG file.
+ *
+ * Must be called before the buffers are swapped.
+ *
+ * @param path Path of the PNG file.
+ *
+ * @throw abcg::Exception if the file could not be written.
+ */
+void abcg::OpenGLWindow::saveFrame(
+    [[maybe_unused]] std::string_view path) const {
+#if !defined(__EMSCRIPTEN__)
+  int width{};
+  int height{};
+  SDL_GL_GetDrawableSize(m_window, &width, &height);
+
+  const auto rowSize{static_cast<std::size_t>(width) * 4};
+  std::vector<unsigned char> pixels(rowSize * static_cast<std::size_t>(height));
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+  // glReadPixels returns the bottom row first
+  std::vector<unsigned char> image(pixels.size());
+  for (auto row : iter::range(static_cast<std::size_t>(height))) {
+    const auto *source{pixels.data() +
+                       (static_cast<std::size_t>(height) - 1 - row) * rowSize};
+    std::copy(source, source + rowSize, image.data() + row * rowSize);
+  }
+
+  auto *surface{SDL_CreateRGBSurfaceWithFormatFrom(
+      image.data(), width, height, 32, static_cast<int>(rowSize),
+      SDL_PIXELFORMAT_RGBA32)};
+  if (surface == nullptr) {
+    throw abcg::Exception{
+        abcg::Exception::SDL("SDL_CreateRGBSurfaceWithFormatFrom failed")};
+  }
+  const auto result{IMG_SavePNG(surface, std::string{path}.c_str())};
+  SDL_FreeSurface(surface);
+  if (result != 0) {
+    throw abcg::Exception{abcg::Exception::SDLImage(
+        fmt::format("Failed to save frame to {}", path))};
+  }
+  fmt::print("Saved frame to {}\n", path);
+#endif
+}
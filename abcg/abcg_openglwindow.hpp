@@ -10,12 +10,22 @@
 #ifndef ABCG_OPENGLWINDOW_HPP_
 #define ABCG_OPENGLWINDOW_HPP_
 
+#include <memory>
+#include <span>
 #include <string>
 
+#include "abcg_assetloader.hpp"
+#include "abcg_benchmark.hpp"
 #include "abcg_elapsedtimer.hpp"
 #include "abcg_external.hpp"
+#include "abcg_glstatecache.hpp"
+#include "abcg_gpuprofiler.hpp"
+#include "abcg_programcache.hpp"
+#include "abcg_programfuture.hpp"
+#include "abcg_shaderprogram.hpp"
 
 namespace abcg {
+enum class GLErrorCheck;
 enum class OpenGLProfile;
 class Application;
 class OpenGLWindow;
@@ -34,6 +44,27 @@ EM_BOOL fullscreenchangeCallback(int eventType,
  */
 enum class abcg::OpenGLProfile { Core, Compatibility, ES };
 
+/**
+ * @brief Enumeration of error checking modes of the OpenGL function wrappers.
+ *
+ * The wrappers are only used in debug builds on platforms other than
+ * Emscripten and macOS. Errors are reported with the source location of the
+ * wrapped call that detected them.
+ *
+ * - PerCall: calls glGetError before and after each call. Every error is
+ * attributed to the call that caused it, but each check stalls the pipeline.
+ * - PerFrame: calls glGetError once per frame, after the frame is rendered.
+ * - Sampled: calls glGetError after every OpenGLSettings::errorCheckInterval
+ * calls.
+ * - DebugOutput: uses a synchronous KHR_debug callback and never calls
+ * glGetError. Errors are attributed to the call that caused them. Falls back
+ * to PerCall if KHR_debug is not supported.
+ *
+ * In the PerFrame and Sampled modes, errors are reported with the locations
+ * of the first and last calls made since the previous check.
+ */
+enum class abcg::GLErrorCheck { PerCall, PerFrame, Sampled, DebugOutput };
+
 struct abcg::OpenGLSettings {
   OpenGLProfile profile{OpenGLProfile::Core};
   int majorVersion{4};
@@ -43,6 +74,19 @@ struct abcg::OpenGLSettings {
   int samples{0};
   bool vsync{false};
   bool preserveWebGLDrawingBuffer{false};
+  GLErrorCheck errorCheck{GLErrorCheck::PerCall};
+  int errorCheckInterval{100};
+  // Frame rate limit of the main loop, or 0 for no limit. With several
+  // windows, the loop is limited only if all windows have a limit, and runs
+  // at the highest of them
+  int targetFPS{0};
+  // If true, the main loop waits for events instead of painting while the
+  // window is not animating (see OpenGLWindow::setAnimating). Ignored in
+  // WebAssembly builds
+  bool idleMode{false};
+  // If true and supported by the driver, linked programs are cached on disk
+  // and loaded from the cache in later runs instead of being built again
+  bool programCache{true};
 };
 
 struct abcg::WindowSettings {
@@ -62,9 +106,9 @@ class abcg::OpenGLWindow {
   OpenGLWindow() = default;
   virtual ~OpenGLWindow();
 
-  OpenGLWindow(const OpenGLWindow&) = default;
+  OpenGLWindow(const OpenGLWindow&) = delete;
   OpenGLWindow(OpenGLWindow&&) = default;
-  OpenGLWindow& operator=(const OpenGLWindow&) = default;
+  OpenGLWindow& operator=(const OpenGLWindow&) = delete;
   OpenGLWindow& operator=(OpenGLWindow&&) = default;
 
   [[nodiscard]] OpenGLSettings getOpenGLSettings() noexcept;
@@ -80,21 +124,33 @@ class abcg::OpenGLWindow {
   virtual void resizeGL(int width, int height);
   virtual void terminateGL();
 
-  [[nodiscard]] GLuint createProgramFromFile(
+  [[nodiscard]] ShaderProgram createProgramFromFile(
+      std::string_view pathToVertexShader,
+      std::string_view pathToFragmentShader);
+  [[nodiscard]] ShaderProgram createProgramFromString(
+      std::string_view vertexShaderSource,
+      std::string_view fragmentShaderSource,
+      std::span<const char* const> transformFeedbackVaryings = {});
+  [[nodiscard]] ProgramFuture createProgramFromFileAsync(
       std::string_view pathToVertexShader,
       std::string_view pathToFragmentShader);
-  [[nodiscard]] GLuint createProgramFromString(
+  [[nodiscard]] ProgramFuture createProgramFromStringAsync(
       std::string_view vertexShaderSource,
-      std::string_view fragmentShaderSource);
+      std::string_view fragmentShaderSource,
+      std::span<const char* const> transformFeedbackVaryings = {});
+  AssetLoader& getAssetLoader();
   std::string getAssetsPath();
   [[nodiscard]] double getDeltaTime() const;
   [[nodiscard]] double getElapsedTime() const;
+  void setAnimating(bool animating);
   void toggleFullscreen();
 
  private:
   void handleEvent(SDL_Event& event, bool& done);
   void initialize(std::string_view basePath);
   void paint();
+  void saveFrame(std::string_view path) const;
+  [[nodiscard]] bool isIdle() const;
 
   WindowSettings m_windowSettings{};
   OpenGLSettings m_openGLSettings{};
@@ -113,6 +169,28 @@ class abcg::OpenGLWindow {
   ElapsedTimer m_windowStartTime;
   double m_lastDeltaTime{0.0};
 
+  // Cleared by the application to allow idle mode
+  bool m_animating{true};
+
+  std::unique_ptr<AssetLoader> m_assetLoader;
+  std::unique_ptr<GpuProfiler> m_gpuProfiler;
+  std::unique_ptr<ProgramCache> m_programCache;
+
+  // Calls counted by abcg::gl in the last frame. Only draws are counted
+  // without the state cache
+  gl::StateCacheCounters m_glStateCounters{};
+
+  // Set by abcg::Application when running with --headless
+  bool m_headless{false};
+  // If not empty, the next frame is saved to this file
+  std::string m_capturePath{};
+
+  // Set by abcg::Application when running with --benchmark. A positive fixed
+  // delta time replaces the wall-clock frame time
+  double m_fixedDeltaTime{0.0};
+  double m_fixedElapsedTime{0.0};
+  std::unique_ptr<BenchmarkRecorder> m_benchmarkRecorder;
+
   friend Application;
 
 #if defined(__EMSCRIPTEN__)
@@ -0,0 +1,185 @@
+/**
+ * @file abcg_programcache.cpp
+ * @brief Definition of abcg::ProgramCache class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_programcache.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+#include "abcg_cachefile.hpp"
+#include "abcg_openglfunctions.hpp"
+
+namespace {
+using abcg::cachefile::fnv1aString;
+
+// Layout version of the program cache files, independent of the mesh cache
+constexpr std::uint32_t cacheVersion{1};
+constexpr std::array<char, 8> cacheMagic{'A', 'B', 'C', 'G', 'P', 'R', 'G', 0};
+
+struct CacheHeader {
+  std::array<char, 8> magic{};
+  std::uint32_t version{};
+  std::uint32_t binaryFormat{};
+  std::uint64_t key{};
+  std::uint64_t binarySize{};
+};
+
+std::string_view getGLString(GLenum name) {
+  const auto *str{reinterpret_cast<const char *>(glGetString(name))};
+  return str == nullptr ? std::string_view{} : std::string_view{str};
+}
+}  // namespace
+
+/**
+ * @brief Constructs an abcg::ProgramCache that stores binaries in a given
+ * directory.
+ *
+ * Must be called with the OpenGL context current, as the cache keys depend
+ * on the driver. The directory is created on the first store().
+ *
+ * @param directory Path to the directory of the cache files.
+ */
+abcg::ProgramCache::ProgramCache(std::string_view directory)
+    : m_directory{directory} {
+  auto key{fnv1aString(getGLString(GL_VENDOR),
+                       abcg::cachefile::fnv1aOffsetBasis)};
+  key = fnv1aString(getGLString(GL_RENDERER), key);
+  // The version string usually includes the driver version, whose compiler
+  // may produce different binaries
+  key = fnv1aString(getGLString(GL_VERSION), key);
+  m_driverKey = key;
+
+  GLint numFormats{};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  m_binaryFormats.resize(static_cast<std::size_t>(std::max(numFormats, 0)));
+  if (numFormats > 0) {
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_binaryFormats.data());
+  }
+}
+
+/**
+ * @brief Returns whether the driver can save and load program binaries.
+ *
+ * Program binaries are not available in WebGL, and some drivers (e.g., on
+ * macOS) support no binary format at all.
+ *
+ * @return true if at least one program binary format is supported.
+ */
+bool abcg::ProgramCache::isSupported() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  GLint numFormats{};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  return numFormats > 0;
+#endif
+}
+
+/**
+ * @brief Computes the cache key of a program.
+ *
+ * @param parts Everything that determines the program binary besides the
+ * driver, such as the preprocessed shader sources and the names of
+ * transform feedback varyings.
+ * @return Key to be used with load() and store().
+ */
+std::uint64_t abcg::ProgramCache::computeKey(
+    std::span<const std::string_view> parts) const {
+  auto key{m_driverKey};
+  for (const auto &part : parts) {
+    key = fnv1aString(part, key);
+  }
+  return key;
+}
+
+/**
+ * @brief Loads a cached binary into a program object.
+ *
+ * @param program Program object without attached shaders.
+ * @param key Cache key of the program.
+ * @return true if the binary was found and accepted by the driver, in which
+ * case the program is linked; false otherwise. After a failure, the program
+ * object is left unlinked and should be deleted.
+ */
+bool abcg::ProgramCache::load(GLuint program, std::uint64_t key) const {
+  std::vector<std::byte> buffer;
+  if (!abcg::cachefile::readFile(getCachePath(key), buffer)) return false;
+  const auto fileSize{buffer.size()};
+  if (fileSize < sizeof(CacheHeader)) return false;
+
+  CacheHeader header{};
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  if (header.magic != cacheMagic || header.version != cacheVersion ||
+      header.key != key ||
+      header.binarySize != fileSize - sizeof(CacheHeader)) {
+    return false;
+  }
+  // Passing a format the driver does not know would raise GL_INVALID_ENUM
+  if (std::ranges::find(m_binaryFormats,
+                        static_cast<GLint>(header.binaryFormat)) ==
+      m_binaryFormats.end()) {
+    return false;
+  }
+
+  // The driver may still reject the binary, e.g. after a driver update that
+  // kept the same version string
+  glProgramBinary(program, header.binaryFormat,
+                  buffer.data() + sizeof(CacheHeader),
+                  static_cast<GLsizei>(header.binarySize));
+  GLint linkStatus{};
+  glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  return linkStatus != 0;
+}
+
+/**
+ * @brief Stores the binary of a linked program.
+ *
+ * The program should have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+ * set, otherwise some drivers return no binary. Failing to write the cache
+ * is not an error: a warning is printed and the program is simply built from
+ * source on the next run.
+ *
+ * @param program Linked program object.
+ * @param key Cache key of the program.
+ */
+void abcg::ProgramCache::store(GLuint program, std::uint64_t key) const {
+  GLint binarySize{};
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+  if (binarySize <= 0) return;
+
+  std::vector<std::byte> binary(static_cast<std::size_t>(binarySize));
+  GLenum binaryFormat{};
+  GLsizei length{};
+  glGetProgramBinary(program, binarySize, &length, &binaryFormat,
+                     binary.data());
+  if (length <= 0) return;
+
+  CacheHeader header{};
+  header.magic = cacheMagic;
+  header.version = cacheVersion;
+  header.binaryFormat = binaryFormat;
+  header.key = key;
+  header.binarySize = static_cast<std::uint64_t>(length);
+
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+
+  abcg::cachefile::writeFile(
+      getCachePath(key),
+      {std::as_bytes(std::span{&header, 1}),
+       std::span{binary}.first(static_cast<std::size_t>(length))},
+      "program cache");
+}
+
+std::string abcg::ProgramCache::getCachePath(std::uint64_t key) const {
+  return (std::filesystem::path{m_directory} / fmt::format("{:016x}.bin", key))
+      .string();
+}
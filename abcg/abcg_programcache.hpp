@@ -0,0 +1,59 @@
+/**
+ * @file abcg_programcache.hpp
+ * @brief abcg::ProgramCache header file.
+ *
+ * Declaration of abcg::ProgramCache class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_PROGRAMCACHE_HPP_
+#define ABCG_PROGRAMCACHE_HPP_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+class ProgramCache;
+}  // namespace abcg
+
+/**
+ * @brief abcg::ProgramCache class.
+ *
+ * On-disk cache of linked program binaries, so that programs already built
+ * in a previous run are loaded with glProgramBinary instead of being
+ * compiled and linked again.
+ *
+ * Each program is stored in its own file, named after a key computed from
+ * everything that determines the binary: the preprocessed shader sources,
+ * the GLSL version header, the transform feedback varyings and the vendor,
+ * renderer and version strings of the driver. Any mismatch is a cache miss,
+ * and a binary rejected by the driver is simply rebuilt from source.
+ */
+class abcg::ProgramCache {
+ public:
+  explicit ProgramCache(std::string_view directory);
+
+  [[nodiscard]] static bool isSupported();
+
+  [[nodiscard]] std::uint64_t computeKey(
+      std::span<const std::string_view> parts) const;
+  [[nodiscard]] bool load(GLuint program, std::uint64_t key) const;
+  void store(GLuint program, std::uint64_t key) const;
+
+  [[nodiscard]] std::string getDirectory() const { return m_directory; }
+
+ private:
+  std::string m_directory{};
+  std::uint64_t m_driverKey{};
+  std::vector<GLint> m_binaryFormats;
+
+  [[nodiscard]] std::string getCachePath(std::uint64_t key) const;
+};
+
+#endif
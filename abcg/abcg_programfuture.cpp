@@ -0,0 +1,196 @@
+/**
+ * @file abcg_programfuture.cpp
+ * @brief Definition of abcg::ProgramFuture class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_programfuture.hpp"
+
+#include <fmt/core.h>
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "abcg_exception.hpp"
+#include "abcg_openglfunctions.hpp"
+
+namespace {
+void printShaderInfoLog(GLuint shader, std::string_view prefix) {
+  GLint infoLogLength{};
+  glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+  if (infoLogLength > 0) {
+    std::vector<GLchar> infoLog(static_cast<std::size_t>(infoLogLength));
+    glGetShaderInfoLog(shader, infoLogLength, nullptr, infoLog.data());
+    fmt::print("{} information log:\n{}\n", prefix, infoLog.data());
+  }
+}
+
+void printProgramInfoLog(GLuint program) {
+  GLint infoLogLength{};
+  glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+  if (infoLogLength > 0) {
+    std::vector<GLchar> infoLog(static_cast<std::size_t>(infoLogLength));
+    glGetProgramInfoLog(program, infoLogLength, nullptr, infoLog.data());
+    fmt::print("Program information log:\n{}\n", infoLog.data());
+  }
+}
+}  // namespace
+
+/**
+ * @brief Constructs a future that is already resolved.
+ *
+ * @param linkedProgram Program object that was successfully linked.
+ */
+abcg::ProgramFuture::ProgramFuture(GLuint linkedProgram)
+    : m_program{linkedProgram} {}
+
+/**
+ * @brief Constructs a future for a program whose build was submitted.
+ *
+ * Takes ownership of the program and shader objects.
+ *
+ * @param program Program object on which glLinkProgram was called.
+ * @param vertexShader Vertex shader attached to the program.
+ * @param fragmentShader Fragment shader attached to the program.
+ * @param cache Cache that receives the binary of the program if it links
+ * successfully, or nullptr.
+ * @param cacheKey Cache key of the program.
+ */
+abcg::ProgramFuture::ProgramFuture(GLuint program, GLuint vertexShader,
+                                   GLuint fragmentShader,
+                                   const ProgramCache *cache,
+                                   std::uint64_t cacheKey)
+    : m_program{program},
+      m_vertexShader{vertexShader},
+      m_fragmentShader{fragmentShader},
+      m_cache{cache},
+      m_cacheKey{cacheKey} {}
+
+/**
+ * @brief Destroys the future, deleting the program if get() was not called.
+ */
+abcg::ProgramFuture::~ProgramFuture() { release(); }
+
+abcg::ProgramFuture::ProgramFuture(ProgramFuture &&other) noexcept
+    : m_program{std::exchange(other.m_program, 0)},
+      m_vertexShader{std::exchange(other.m_vertexShader, 0)},
+      m_fragmentShader{std::exchange(other.m_fragmentShader, 0)},
+      m_cache{std::exchange(other.m_cache, nullptr)},
+      m_cacheKey{std::exchange(other.m_cacheKey, 0)} {}
+
+abcg::ProgramFuture &abcg::ProgramFuture::operator=(ProgramFuture &&other) {
+  if (this != &other) {
+    release();
+    m_program = std::exchange(other.m_program, 0);
+    m_vertexShader = std::exchange(other.m_vertexShader, 0);
+    m_fragmentShader = std::exchange(other.m_fragmentShader, 0);
+    m_cache = std::exchange(other.m_cache, nullptr);
+    m_cacheKey = std::exchange(other.m_cacheKey, 0);
+  }
+  return *this;
+}
+
+/**
+ * @brief Returns whether the driver reports the completion of shader
+ * compiles and program links without blocking.
+ *
+ * @return True if KHR_parallel_shader_compile or ARB_parallel_shader_compile
+ * is supported.
+ */
+bool abcg::ProgramFuture::isParallelCompileSupported() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  return GLEW_KHR_parallel_shader_compile != GL_FALSE ||
+         GLEW_ARB_parallel_shader_compile != GL_FALSE;
+#endif
+}
+
+/**
+ * @brief Returns whether get() can be called without waiting for the
+ * driver.
+ *
+ * Polls GL_COMPLETION_STATUS_KHR of the program. If parallel compilation is
+ * not supported there is no way to know without blocking, and the future is
+ * always reported as ready.
+ *
+ * @return True if the build has finished, or if its completion cannot be
+ * queried; false if it is still in progress or the future is not valid.
+ */
+bool abcg::ProgramFuture::isReady() const {
+  if (!valid()) return false;
+  if (m_vertexShader == 0 || !isParallelCompileSupported()) return true;
+
+  GLint completionStatus{};
+  glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &completionStatus);
+  return completionStatus != GL_FALSE;
+}
+
+/**
+ * @brief Waits for the build to finish and returns the program.
+ *
+ * The future is no longer valid after this call, even if it throws. If
+ * the program links successfully and a cache was given, its binary is
+ * stored in the cache.
+ *
+ * @return Handle to the linked program.
+ *
+ * @throw abcg::Exception if the future is not valid, a shader failed to
+ * compile or the program failed to link. The information log of the shader
+ * or program is printed to the console.
+ */
+abcg::ShaderProgram abcg::ProgramFuture::get() {
+  if (!valid()) {
+    throw abcg::Exception{
+        abcg::Exception::Runtime("Program future is not valid")};
+  }
+
+  // Objects still owned by the local future are deleted if this throws
+  ProgramFuture future{std::move(*this)};
+
+  if (future.m_vertexShader != 0) {
+    GLint compileStatus{};
+    glGetShaderiv(future.m_vertexShader, GL_COMPILE_STATUS, &compileStatus);
+    if (compileStatus == 0) {
+      printShaderInfoLog(future.m_vertexShader, "Vertex shader");
+      throw abcg::Exception{
+          abcg::Exception::Runtime("Failed to compile vertex shader")};
+    }
+
+    glGetShaderiv(future.m_fragmentShader, GL_COMPILE_STATUS, &compileStatus);
+    if (compileStatus == 0) {
+      printShaderInfoLog(future.m_fragmentShader, "Fragment shader");
+      throw abcg::Exception{
+          abcg::Exception::Runtime("Failed to compile fragment shader")};
+    }
+
+    GLint linkStatus{};
+    glGetProgramiv(future.m_program, GL_LINK_STATUS, &linkStatus);
+    if (linkStatus == 0) {
+      printProgramInfoLog(future.m_program);
+      throw abcg::Exception{abcg::Exception::Runtime("Failed to link program")};
+    }
+
+    glDeleteShader(std::exchange(future.m_fragmentShader, 0));
+    glDeleteShader(std::exchange(future.m_vertexShader, 0));
+
+    if (future.m_cache != nullptr) {
+      future.m_cache->store(future.m_program, future.m_cacheKey);
+    }
+  }
+
+  return ShaderProgram{std::exchange(future.m_program, 0)};
+}
+
+void abcg::ProgramFuture::release() {
+  if (m_fragmentShader != 0) glDeleteShader(m_fragmentShader);
+  if (m_vertexShader != 0) glDeleteShader(m_vertexShader);
+  if (m_program != 0) glDeleteProgram(m_program);
+  m_program = 0;
+  m_vertexShader = 0;
+  m_fragmentShader = 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file abcg_programfuture.hpp
+ * @brief abcg::ProgramFuture header file.
+ *
+ * Declaration of abcg::ProgramFuture class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_PROGRAMFUTURE_HPP_
+#define ABCG_PROGRAMFUTURE_HPP_
+
+#include <cstdint>
+
+#include "abcg_external.hpp"
+#include "abcg_programcache.hpp"
+#include "abcg_shaderprogram.hpp"
+
+namespace abcg {
+class ProgramFuture;
+}  // namespace abcg
+
+/**
+ * @brief abcg::ProgramFuture class.
+ *
+ * Result of a program build that was submitted to the driver but not yet
+ * checked. Its shaders have been compiled and the program linked, but the
+ * compile and link status, which block until the driver has finished, are
+ * only queried by get().
+ *
+ * Submitting every program before calling get() on any of them lets drivers
+ * with background compiler threads build them concurrently. With
+ * KHR_parallel_shader_compile, isReady() tells whether get() would block.
+ *
+ * Like std::future, it is move-only and get() can be called only once. It
+ * must be resolved or destroyed on the thread of the OpenGL context that
+ * created it, while the context exists.
+ */
+class abcg::ProgramFuture {
+ public:
+  ProgramFuture() = default;
+  explicit ProgramFuture(GLuint linkedProgram);
+  ProgramFuture(GLuint program, GLuint vertexShader, GLuint fragmentShader,
+                const ProgramCache* cache, std::uint64_t cacheKey);
+  ~ProgramFuture();
+
+  ProgramFuture(const ProgramFuture&) = delete;
+  ProgramFuture(ProgramFuture&& other) noexcept;
+  ProgramFuture& operator=(const ProgramFuture&) = delete;
+  ProgramFuture& operator=(ProgramFuture&& other);
+
+  [[nodiscard]] static bool isParallelCompileSupported();
+
+  [[nodiscard]] bool valid() const noexcept { return m_program != 0; }
+  [[nodiscard]] bool isReady() const;
+  [[nodiscard]] ShaderProgram get();
+
+ private:
+  GLuint m_program{};
+  // Zero if the program was linked on creation (e.g., loaded from the cache)
+  GLuint m_vertexShader{};
+  GLuint m_fragmentShader{};
+
+  // Cache that receives the binary once the link is checked, if any
+  const ProgramCache* m_cache{};
+  std::uint64_t m_cacheKey{};
+
+  void release();
+};
+
+#endif
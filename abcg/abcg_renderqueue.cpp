@@ -0,0 +1,120 @@
+/**
+ * @file abcg_renderqueue.cpp
+ * @brief Definition of abcg::RenderQueue class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_renderqueue.hpp"
+
+#include <algorithm>
+
+#include "abcg_openglfunctions.hpp"
+
+/**
+ * @brief Adds a draw item to the queue.
+ *
+ * @param item Draw call and its state.
+ * @param uniforms Uniform variables of the item's program to set before the
+ * draw call. Names must remain valid until submit() is called.
+ */
+void abcg::RenderQueue::push(const DrawItem &item,
+                             std::initializer_list<Uniform> uniforms) {
+  m_entries.push_back(
+      {computeKey(item), static_cast<std::uint32_t>(m_items.size())});
+  m_items.push_back(item);
+  m_uniforms.insert(m_uniforms.end(), uniforms.begin(), uniforms.end());
+  m_uniformOffsets.push_back(m_uniforms.size());
+}
+
+/**
+ * @brief Sorts and issues all queued draw calls, and clears the queue.
+ *
+ * The program and VAO are unbound on return. Texture bindings are left as
+ * set by the last draw.
+ */
+void abcg::RenderQueue::submit() {
+  std::stable_sort(
+      m_entries.begin(), m_entries.end(),
+      [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+  m_stats = {};
+
+  // No state is assumed to be bound at the start
+  auto currentProgram{~GLuint{}};
+  auto currentVAO{~GLuint{}};
+  std::array<GLuint, maxTextures> currentTextures{};
+  currentTextures.fill(~GLuint{});
+  GLenum currentUnit{GL_TEXTURE0};
+  glActiveTexture(currentUnit);
+
+  for (const auto &entry : m_entries) {
+    const auto &item{m_items[entry.item]};
+    const auto &program{*item.program};
+
+    if (program.getId() != currentProgram) {
+      currentProgram = program.getId();
+      glUseProgram(currentProgram);
+      ++m_stats.programBinds;
+    }
+
+    if (item.vao != currentVAO) {
+      currentVAO = item.vao;
+      glBindVertexArray(currentVAO);
+      ++m_stats.vaoBinds;
+    }
+
+    for (std::size_t unit{}; unit < maxTextures; ++unit) {
+      const auto &texture{item.textures.at(unit)};
+      if (texture.id == 0 || texture.id == currentTextures.at(unit)) continue;
+
+      if (const auto textureUnit{static_cast<GLenum>(GL_TEXTURE0 + unit)};
+          textureUnit != currentUnit) {
+        currentUnit = textureUnit;
+        glActiveTexture(currentUnit);
+      }
+      glBindTexture(texture.target, texture.id);
+      currentTextures.at(unit) = texture.id;
+      ++m_stats.textureBinds;
+    }
+
+    for (auto index{m_uniformOffsets[entry.item]};
+         index < m_uniformOffsets[entry.item + 1]; ++index) {
+      const auto &uniform{m_uniforms[index]};
+      std::visit(
+          [&](const auto &value) { program.setUniform(uniform.first, value); },
+          uniform.second);
+    }
+
+    glDrawElements(item.mode, item.count, GL_UNSIGNED_INT,
+                   reinterpret_cast<void *>(item.firstIndex * sizeof(GLuint)));
+    ++m_stats.draws;
+  }
+
+  if (currentUnit != GL_TEXTURE0) glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(0);
+  glUseProgram(0);
+
+  clear();
+}
+
+/**
+ * @brief Removes all queued draw items without issuing them.
+ */
+void abcg::RenderQueue::clear() {
+  m_items.clear();
+  m_entries.clear();
+  m_uniforms.clear();
+  m_uniformOffsets.assign(1, 0);
+}
+
+// Program in bits 48-63, first texture in bits 24-47 and VAO in bits 0-23.
+// Names wider than their field only make sorting less effective: submit()
+// compares the actual state before binding.
+std::uint64_t abcg::RenderQueue::computeKey(const DrawItem &item) noexcept {
+  const std::uint64_t program{item.program ? item.program->getId() : 0U};
+  const std::uint64_t texture{item.textures[0].id};
+  const std::uint64_t vao{item.vao};
+  return ((program & 0xFFFFU) << 48U) | ((texture & 0xFFFFFFU) << 24U) |
+         (vao & 0xFFFFFFU);
+}
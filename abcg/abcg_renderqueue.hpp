@@ -0,0 +1,113 @@
+/**
+ * @file abcg_renderqueue.hpp
+ * @brief abcg::RenderQueue header file.
+ *
+ * Declaration of abcg::RenderQueue class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_RENDERQUEUE_HPP_
+#define ABCG_RENDERQUEUE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "abcg_external.hpp"
+#include "abcg_shaderprogram.hpp"
+
+namespace abcg {
+class RenderQueue;
+}  // namespace abcg
+
+/**
+ * @brief abcg::RenderQueue class.
+ *
+ * Collects indexed draw calls and submits them sorted by render state.
+ *
+ * Each draw item is assigned a 64-bit key made of its program, its first
+ * texture and its VAO, from the most to the least significant bits. Sorting
+ * by this key groups draws that share state, and submit() then binds a
+ * program, VAO or texture only when it differs from the one already bound.
+ * Draws with equal keys keep their submission order.
+ *
+ * Per-item uniforms are set through abcg::ShaderProgram::setUniform, so
+ * values that are equal to those of the previous draw are not uploaded again.
+ */
+class abcg::RenderQueue {
+ public:
+  /** @brief Number of texture units that a draw item can bind. */
+  static constexpr std::size_t maxTextures{4};
+
+  /** @brief Texture bound to a texture unit. Units with a zero id are not
+   * changed. */
+  struct Texture {
+    GLenum target{GL_TEXTURE_2D};
+    GLuint id{};
+  };
+
+  /** @brief Indexed draw call and the state it needs. */
+  struct DrawItem {
+    /** @brief Program to use. Must not be null and must outlive submit(). */
+    const ShaderProgram* program{};
+    /** @brief VAO with the element buffer of GL_UNSIGNED_INT indices. */
+    GLuint vao{};
+    /** @brief Textures bound to units 0 to maxTextures - 1. */
+    std::array<Texture, maxTextures> textures{};
+    GLenum mode{GL_TRIANGLES};
+    /** @brief Number of indices to draw. */
+    GLsizei count{};
+    /** @brief Position of the first index in the element buffer. */
+    std::size_t firstIndex{};
+  };
+
+  using UniformValue = std::variant<GLint, GLfloat, glm::vec2, glm::vec3,
+                                    glm::vec4, glm::mat3, glm::mat4>;
+
+  /** @brief Uniform variable set before a draw. The name is not copied. */
+  using Uniform = std::pair<std::string_view, UniformValue>;
+
+  /** @brief State changes and draw calls issued by the last submit(). */
+  struct Stats {
+    std::size_t draws{};
+    std::size_t programBinds{};
+    std::size_t vaoBinds{};
+    std::size_t textureBinds{};
+  };
+
+  void push(const DrawItem& item, std::initializer_list<Uniform> uniforms = {});
+  void submit();
+  void clear();
+
+  [[nodiscard]] std::size_t size() const noexcept { return m_items.size(); }
+  [[nodiscard]] const Stats& getStats() const noexcept { return m_stats; }
+
+ private:
+  struct Entry {
+    std::uint64_t key{};
+    std::uint32_t item{};
+  };
+
+  std::vector<DrawItem> m_items;
+  std::vector<Entry> m_entries;
+  // Uniforms of item i are in [m_uniformOffsets[i], m_uniformOffsets[i + 1])
+  std::vector<Uniform> m_uniforms;
+  std::vector<std::size_t> m_uniformOffsets{0};
+
+  Stats m_stats;
+
+  static std::uint64_t computeKey(const DrawItem& item) noexcept;
+};
+
+#endif
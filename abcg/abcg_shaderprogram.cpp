@@ -0,0 +1,296 @@
+/**
+ * @file abcg_shaderprogram.cpp
+ * @brief Definition of abcg::ShaderProgram class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_shaderprogram.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cstring>
+#include <glm/matrix.hpp>
+#include <utility>
+
+#include "abcg_openglfunctions.hpp"
+#include "abcg_uniformbuffer.hpp"
+
+/**
+ * @brief Constructs an abcg::ShaderProgram from a linked program object.
+ *
+ * Queries the names and locations of all active uniforms and attributes.
+ * Each element of a uniform array can be looked up as `name[i]`, and the
+ * first element also as `name`. Uniforms that belong to uniform blocks have
+ * no location and are not included.
+ *
+ * If the program declares the abcg::FrameUniforms block, the block is bound
+ * to abcg::FrameUniforms::binding.
+ *
+ * @param program Name of a successfully linked program object.
+ */
+abcg::ShaderProgram::ShaderProgram(GLuint program)
+    : m_program{program}, m_reflection{std::make_shared<Reflection>()} {
+  GLint numUniforms{};
+  GLint maxUniformLength{};
+  glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &numUniforms);
+  glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxUniformLength);
+
+  std::string buffer(static_cast<std::size_t>(std::max(maxUniformLength, 1)),
+                     '\0');
+  for (GLint index{}; index < numUniforms; ++index) {
+    GLsizei length{};
+    GLint size{};
+    GLenum type{};
+    glGetActiveUniform(program, static_cast<GLuint>(index),
+                       static_cast<GLsizei>(buffer.size()), &length, &size,
+                       &type, buffer.data());
+    std::string name{buffer.data(), static_cast<std::size_t>(length)};
+
+    const auto location{glGetUniformLocation(program, name.c_str())};
+    if (location < 0) continue;
+
+    auto &uniforms{m_reflection->uniforms};
+    auto &uniformIndices{m_reflection->uniformIndices};
+    uniforms.push_back(Uniform{location, {}});
+    uniformIndices.try_emplace(name, uniforms.size() - 1);
+
+    // Arrays are reported once, as `name[0]`, with the number of elements
+    if (name.ends_with("[0]")) {
+      name.resize(name.size() - 3);
+      uniformIndices.try_emplace(name, uniforms.size() - 1);
+
+      for (GLint element{1}; element < size; ++element) {
+        auto elementName{fmt::format("{}[{}]", name, element)};
+        const auto elementLocation{
+            glGetUniformLocation(program, elementName.c_str())};
+        if (elementLocation < 0) continue;
+        uniforms.push_back(Uniform{elementLocation, {}});
+        uniformIndices.try_emplace(std::move(elementName),
+                                   uniforms.size() - 1);
+      }
+    }
+  }
+
+  GLint numAttributes{};
+  GLint maxAttributeLength{};
+  glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &numAttributes);
+  glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxAttributeLength);
+
+  buffer.assign(static_cast<std::size_t>(std::max(maxAttributeLength, 1)),
+                '\0');
+  for (GLint index{}; index < numAttributes; ++index) {
+    GLsizei length{};
+    GLint size{};
+    GLenum type{};
+    glGetActiveAttrib(program, static_cast<GLuint>(index),
+                      static_cast<GLsizei>(buffer.size()), &length, &size,
+                      &type, buffer.data());
+    const std::string name{buffer.data(), static_cast<std::size_t>(length)};
+
+    if (const auto location{glGetAttribLocation(program, name.c_str())};
+        location >= 0) {
+      m_reflection->attributes.try_emplace(name, location);
+    }
+  }
+
+  if (const auto blockIndex{
+          glGetUniformBlockIndex(program, FrameUniforms::blockName)};
+      blockIndex != GL_INVALID_INDEX) {
+    glUniformBlockBinding(program, blockIndex, FrameUniforms::binding);
+  }
+}
+
+/**
+ * @brief Returns the location of an active vertex attribute.
+ *
+ * @param name Name of the attribute.
+ * @return Location of the attribute, or -1 if it is not an active attribute.
+ */
+GLint abcg::ShaderProgram::getAttribLocation(std::string_view name) const {
+  if (!m_reflection) return -1;
+  const auto &attributes{m_reflection->attributes};
+  const auto it{attributes.find(name)};
+  return it == attributes.end() ? -1 : it->second;
+}
+
+/**
+ * @brief Returns the location of an active uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @return Location of the uniform variable, or -1 if it is not an active
+ * uniform.
+ */
+GLint abcg::ShaderProgram::getUniformLocation(std::string_view name) const {
+  if (!m_reflection) return -1;
+  const auto &uniformIndices{m_reflection->uniformIndices};
+  const auto it{uniformIndices.find(name)};
+  return it == uniformIndices.end()
+             ? -1
+             : m_reflection->uniforms[it->second].location;
+}
+
+/**
+ * @brief Sets an int (or sampler) uniform variable.
+ *
+ * As with glUniform*, the program must be the current program. Unknown names
+ * are ignored.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     GLint value) const {
+  if (const auto location{updateUniform(name, &value, sizeof(value))};
+      location >= 0) {
+    glUniform1i(location, value);
+  }
+}
+
+/**
+ * @brief Sets a float uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     GLfloat value) const {
+  if (const auto location{updateUniform(name, &value, sizeof(value))};
+      location >= 0) {
+    glUniform1f(location, value);
+  }
+}
+
+/**
+ * @brief Sets a vec2 uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     const glm::vec2 &value) const {
+  if (const auto location{updateUniform(name, &value, sizeof(value))};
+      location >= 0) {
+    glUniform2fv(location, 1, &value.x);
+  }
+}
+
+/**
+ * @brief Sets a vec3 uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     const glm::vec3 &value) const {
+  if (const auto location{updateUniform(name, &value, sizeof(value))};
+      location >= 0) {
+    glUniform3fv(location, 1, &value.x);
+  }
+}
+
+/**
+ * @brief Sets a vec4 uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     const glm::vec4 &value) const {
+  if (const auto location{updateUniform(name, &value, sizeof(value))};
+      location >= 0) {
+    glUniform4fv(location, 1, &value.x);
+  }
+}
+
+/**
+ * @brief Sets a mat3 uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ * @param transpose Whether the matrix is given in row-major order.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     const glm::mat3 &value,
+                                     bool transpose) const {
+  // Transpose here so that the cache always holds column-major values
+  const auto matrix{transpose ? glm::transpose(value) : value};
+  if (const auto location{updateUniform(name, &matrix, sizeof(matrix))};
+      location >= 0) {
+    glUniformMatrix3fv(location, 1, GL_FALSE, &matrix[0][0]);
+  }
+}
+
+/**
+ * @brief Sets a mat4 uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ * @param value New value.
+ * @param transpose Whether the matrix is given in row-major order.
+ */
+void abcg::ShaderProgram::setUniform(std::string_view name,
+                                     const glm::mat4 &value,
+                                     bool transpose) const {
+  const auto matrix{transpose ? glm::transpose(value) : value};
+  if (const auto location{updateUniform(name, &matrix, sizeof(matrix))};
+      location >= 0) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, &matrix[0][0]);
+  }
+}
+
+/**
+ * @brief Forgets the cached uniform values.
+ *
+ * Must be called after uniforms of this program are changed by other means
+ * than setUniform() (e.g., by calling glUniform* directly), so that the next
+ * setUniform() calls are not skipped.
+ */
+void abcg::ShaderProgram::invalidateUniformCache() const {
+  if (!m_reflection) return;
+  for (auto &uniform : m_reflection->uniforms) {
+    uniform.value.clear();
+  }
+}
+
+/**
+ * @brief Returns the number of glUniform* calls issued by setUniform().
+ *
+ * @return Number of calls issued since the program was created.
+ */
+std::size_t abcg::ShaderProgram::getIssuedUniformCount() const noexcept {
+  return m_reflection ? m_reflection->issuedCount : 0;
+}
+
+/**
+ * @brief Returns the number of setUniform() calls skipped because the value
+ * did not change.
+ *
+ * @return Number of calls skipped since the program was created.
+ */
+std::size_t abcg::ShaderProgram::getSkippedUniformCount() const noexcept {
+  return m_reflection ? m_reflection->skippedCount : 0;
+}
+
+// Returns the location to upload to, or -1 if the uniform is not active or
+// already holds the given value
+GLint abcg::ShaderProgram::updateUniform(std::string_view name,
+                                         const void *data,
+                                         std::size_t size) const {
+  if (!m_reflection) return -1;
+  const auto &uniformIndices{m_reflection->uniformIndices};
+  const auto it{uniformIndices.find(name)};
+  if (it == uniformIndices.end()) return -1;
+
+  auto &uniform{m_reflection->uniforms[it->second]};
+  auto &cached{uniform.value};
+  if (cached.size() == size && std::memcmp(cached.data(), data, size) == 0) {
+    ++m_reflection->skippedCount;
+    return -1;
+  }
+
+  cached.resize(size);
+  std::memcpy(cached.data(), data, size);
+  ++m_reflection->issuedCount;
+  return uniform.location;
+}
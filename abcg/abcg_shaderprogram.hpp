@@ -0,0 +1,107 @@
+/**
+ * @file abcg_shaderprogram.hpp
+ * @brief abcg::ShaderProgram header file.
+ *
+ * Declaration of abcg::ShaderProgram class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_SHADERPROGRAM_HPP_
+#define ABCG_SHADERPROGRAM_HPP_
+
+#include <cstddef>
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+class ShaderProgram;
+}  // namespace abcg
+
+/**
+ * @brief abcg::ShaderProgram class.
+ *
+ * Handle to a linked OpenGL program object, with the locations of its active
+ * uniforms and attributes reflected once at construction.
+ *
+ * Lookups by name are hash table queries that do not call OpenGL. The
+ * setUniform() functions also keep a copy of the last value uploaded to each
+ * uniform and skip the glUniform* call when the new value is the same.
+ *
+ * Copies share the same reflection data and uniform cache. The handle does
+ * not own the program object: it must still be deleted with glDeleteProgram.
+ * It converts implicitly to GLuint, so it can be used wherever a program
+ * name is expected.
+ */
+class abcg::ShaderProgram {
+ public:
+  ShaderProgram() = default;
+  explicit ShaderProgram(GLuint program);
+
+  // NOLINTNEXTLINE(hicpp-explicit-conversions)
+  operator GLuint() const noexcept { return m_program; }
+  [[nodiscard]] GLuint getId() const noexcept { return m_program; }
+
+  [[nodiscard]] GLint getAttribLocation(std::string_view name) const;
+  [[nodiscard]] GLint getUniformLocation(std::string_view name) const;
+
+  void setUniform(std::string_view name, GLint value) const;
+  void setUniform(std::string_view name, GLfloat value) const;
+  void setUniform(std::string_view name, const glm::vec2& value) const;
+  void setUniform(std::string_view name, const glm::vec3& value) const;
+  void setUniform(std::string_view name, const glm::vec4& value) const;
+  void setUniform(std::string_view name, const glm::mat3& value,
+                  bool transpose = false) const;
+  void setUniform(std::string_view name, const glm::mat4& value,
+                  bool transpose = false) const;
+
+  void invalidateUniformCache() const;
+
+  [[nodiscard]] std::size_t getIssuedUniformCount() const noexcept;
+  [[nodiscard]] std::size_t getSkippedUniformCount() const noexcept;
+
+ private:
+  struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const noexcept {
+      return std::hash<std::string_view>{}(str);
+    }
+  };
+
+  struct Uniform {
+    GLint location{-1};
+    // Last value uploaded through setUniform; empty if unknown
+    std::vector<std::byte> value;
+  };
+
+  struct Reflection {
+    std::vector<Uniform> uniforms;
+    // Maps each name of a uniform to its index in uniforms. Aliases of the
+    // same location (e.g., `name` and `name[0]` of an array) share an index,
+    // and therefore the cached value
+    std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>>
+        uniformIndices;
+    std::unordered_map<std::string, GLint, StringHash, std::equal_to<>>
+        attributes;
+    std::size_t issuedCount{};
+    std::size_t skippedCount{};
+  };
+
+  [[nodiscard]] GLint updateUniform(std::string_view name, const void* data,
+                                    std::size_t size) const;
+
+  GLuint m_program{};
+  std::shared_ptr<Reflection> m_reflection;
+};
+
+#endif
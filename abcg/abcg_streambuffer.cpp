@@ -0,0 +1,167 @@
+/**
+ * @file abcg_streambuffer.cpp
+ * @brief Definition of abcg::StreamBuffer class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_streambuffer.hpp"
+
+#include <fmt/core.h>
+
+#include <cstring>
+
+#include "abcg_exception.hpp"
+#include "abcg_openglfunctions.hpp"
+
+/**
+ * @brief Returns whether buffers can be persistently mapped.
+ *
+ * @return True if OpenGL 4.4 or ARB_buffer_storage is supported.
+ */
+bool abcg::StreamBuffer::isPersistentMappingSupported() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  return GLEW_VERSION_4_4 != GL_FALSE || GLEW_ARB_buffer_storage != GL_FALSE;
+#endif
+}
+
+/**
+ * @brief Creates the buffer object.
+ *
+ * Any buffer previously created by this object is destroyed.
+ *
+ * @param frameCapacity Maximum number of bytes pushed in a frame.
+ * @param target Target the buffer is bound to when written, such as
+ * GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+ */
+void abcg::StreamBuffer::create(GLsizeiptr frameCapacity, GLenum target) {
+  destroy();
+
+  m_target = target;
+  m_frameCapacity = frameCapacity;
+  m_region = 0;
+  m_used = 0;
+
+  glGenBuffers(1, &m_buffer);
+  glBindBuffer(m_target, m_buffer);
+
+#if !defined(__EMSCRIPTEN__)
+  if (isPersistentMappingSupported()) {
+    const auto size{m_frameCapacity * static_cast<GLsizeiptr>(frameLatency)};
+    const GLbitfield flags{GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                           GL_MAP_COHERENT_BIT};
+    glBufferStorage(m_target, size, nullptr, flags);
+    m_mapped = static_cast<std::byte *>(
+        glMapBufferRange(m_target, 0, size, flags));
+  }
+#endif
+
+  if (m_mapped == nullptr) {
+    glBufferData(m_target, m_frameCapacity, nullptr, GL_STREAM_DRAW);
+  }
+
+  glBindBuffer(m_target, 0);
+}
+
+/**
+ * @brief Deletes the buffer object and the fences of the frames in flight.
+ */
+void abcg::StreamBuffer::destroy() {
+  for (auto &fence : m_fences) {
+    if (fence != nullptr) glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  if (m_buffer == 0) return;
+
+  // Deleting a buffer object unmaps it
+  glDeleteBuffers(1, &m_buffer);
+  m_buffer = 0;
+  m_mapped = nullptr;
+  m_frameCapacity = 0;
+}
+
+/**
+ * @brief Starts a frame.
+ *
+ * With persistent mapping, moves to the next region and waits until the GPU
+ * has finished reading the data written to it frameLatency frames ago.
+ * Otherwise, orphans the previous contents of the buffer, so that writing
+ * does not wait for draws still reading them.
+ */
+void abcg::StreamBuffer::beginFrame() {
+  m_used = 0;
+
+  if (m_mapped == nullptr) {
+    glBindBuffer(m_target, m_buffer);
+    glBufferData(m_target, m_frameCapacity, nullptr, GL_STREAM_DRAW);
+    return;
+  }
+
+  m_region = (m_region + 1) % frameLatency;
+  auto &fence{m_fences.at(m_region)};
+  if (fence == nullptr) return;
+
+  // Usually signaled already, since the region was used frames ago
+  constexpr GLuint64 timeout{1'000'000'000};
+  auto status{glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout)};
+  while (status == GL_TIMEOUT_EXPIRED) {
+    status = glClientWaitSync(fence, 0, timeout);
+  }
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+/**
+ * @brief Ends the frame.
+ *
+ * Must be called after the draw calls that read the data of the frame.
+ */
+void abcg::StreamBuffer::endFrame() {
+  if (m_mapped == nullptr) return;
+  m_fences.at(m_region) = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/**
+ * @brief Appends data to the current frame.
+ *
+ * The buffer is left bound to its target.
+ *
+ * @param data Pointer to the data.
+ * @param size Size of the data in bytes.
+ * @param alignment Alignment of the data in the buffer, in bytes. Need not
+ * be a power of two.
+ *
+ * @throw abcg::Exception if the data does not fit in the frame capacity.
+ *
+ * @return Offset of the data in the buffer, in bytes.
+ */
+GLintptr abcg::StreamBuffer::push(const void *data, GLsizeiptr size,
+                                  GLsizeiptr alignment) {
+  // Align the offset in the whole buffer, not in the region
+  const auto regionStart{m_mapped == nullptr
+                             ? GLintptr{0}
+                             : static_cast<GLintptr>(m_region) *
+                                   m_frameCapacity};
+  auto offset{regionStart + m_used};
+  offset = (offset + alignment - 1) / alignment * alignment;
+
+  if (offset + size > regionStart + m_frameCapacity) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Stream buffer push of {} bytes exceeds frame capacity "
+                    "of {} bytes",
+                    size, m_frameCapacity))};
+  }
+
+  glBindBuffer(m_target, m_buffer);
+  if (m_mapped != nullptr) {
+    std::memcpy(m_mapped + offset, data, static_cast<std::size_t>(size));
+  } else {
+    glBufferSubData(m_target, offset, size, data);
+  }
+
+  m_used = offset + size - regionStart;
+  return offset;
+}
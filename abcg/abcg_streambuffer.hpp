@@ -0,0 +1,93 @@
+/**
+ * @file abcg_streambuffer.hpp
+ * @brief abcg::StreamBuffer header file.
+ *
+ * Declaration of abcg::StreamBuffer class.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_STREAMBUFFER_HPP_
+#define ABCG_STREAMBUFFER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+class StreamBuffer;
+}  // namespace abcg
+
+/**
+ * @brief abcg::StreamBuffer class.
+ *
+ * Ring allocator for geometry that changes every frame. Data is appended to
+ * a single buffer object that is created once, so drawing dynamic geometry
+ * creates no OpenGL objects.
+ *
+ * If ARB_buffer_storage is supported, the buffer holds frameLatency regions
+ * of the frame capacity and is persistently mapped. Each frame writes to the
+ * next region, and a fence placed at the end of the frame is waited on
+ * before the region is written again. Otherwise (e.g. on OpenGL ES, WebGL or
+ * macOS), the buffer is orphaned at the beginning of each frame and written
+ * with glBufferSubData.
+ *
+ * Data pushed between beginFrame() and endFrame() is valid for the draw
+ * calls of that frame only.
+ */
+class abcg::StreamBuffer {
+ public:
+  /** @brief Number of frames whose data can be in flight at once. */
+  static constexpr std::size_t frameLatency{3};
+
+  void create(GLsizeiptr frameCapacity, GLenum target = GL_ARRAY_BUFFER);
+  void destroy();
+
+  void beginFrame();
+  void endFrame();
+
+  GLintptr push(const void* data, GLsizeiptr size, GLsizeiptr alignment = 4);
+
+  /**
+   * @brief Appends an array of vertices.
+   *
+   * The data is aligned to the size of a vertex, so that attributes set up
+   * with offset 0 and stride sizeof(T) read it starting at the returned
+   * index.
+   *
+   * @param vertices Vertices to append.
+   * @return Index of the first vertex, to be used as the first argument of
+   * glDrawArrays.
+   */
+  template <typename T, std::size_t Extent>
+  GLint pushVertices(std::span<T, Extent> vertices) {
+    const auto offset{push(vertices.data(),
+                           static_cast<GLsizeiptr>(vertices.size_bytes()),
+                           sizeof(T))};
+    return static_cast<GLint>(offset / static_cast<GLintptr>(sizeof(T)));
+  }
+
+  [[nodiscard]] GLuint getId() const noexcept { return m_buffer; }
+  [[nodiscard]] bool isPersistent() const noexcept {
+    return m_mapped != nullptr;
+  }
+
+ private:
+  GLuint m_buffer{};
+  GLenum m_target{GL_ARRAY_BUFFER};
+  GLsizeiptr m_frameCapacity{};
+
+  // Region written in the current frame, and bytes used in it
+  std::size_t m_region{};
+  GLsizeiptr m_used{};
+
+  // Persistent mapping of all regions, and fences of the regions in flight
+  std::byte* m_mapped{};
+  std::array<GLsync, frameLatency> m_fences{};
+
+  [[nodiscard]] static bool isPersistentMappingSupported();
+};
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file abcg_tracer.cpp
+ * @brief Definition of abcg::Tracer class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_tracer.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "abcg_exception.hpp"
+#include "abcg_string.hpp"
+
+namespace {
+// Fields are atomic so that a buffer can be read while its thread records
+struct TraceEvent {
+  std::atomic<const char *> name{};
+  std::atomic<std::int64_t> start{};
+  std::atomic<std::int64_t> end{};
+};
+
+// Ring buffer written only by its thread. head is the number of events
+// recorded so far
+struct ThreadBuffer {
+  std::array<TraceEvent, abcg::Tracer::bufferCapacity> events{};
+  std::atomic<std::uint64_t> head{};
+  int threadId{};
+};
+
+// Buffers are shared with the registry so that events of threads that have
+// finished can still be written
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+const auto epoch{std::chrono::steady_clock::now()};
+
+ThreadBuffer &getThreadBuffer() {
+  thread_local const auto buffer{[] {
+    auto newBuffer{std::make_shared<ThreadBuffer>()};
+    const std::lock_guard lock{registryMutex};
+    newBuffer->threadId = static_cast<int>(registry.size()) + 1;
+    registry.push_back(newBuffer);
+    return newBuffer;
+  }()};
+  return *buffer;
+}
+}  // namespace
+
+/**
+ * @brief Returns the current time of the trace clock.
+ *
+ * @return Time in nanoseconds since the program started.
+ */
+std::int64_t abcg::Tracer::now() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+/**
+ * @brief Records an event in the buffer of the calling thread.
+ *
+ * @param name Name of the event. The string is not copied.
+ * @param start Start time, as returned by now().
+ * @param end End time, as returned by now().
+ */
+void abcg::Tracer::record(const char *name, std::int64_t start,
+                          std::int64_t end) noexcept {
+  auto &buffer{getThreadBuffer()};
+  const auto head{buffer.head.load(std::memory_order_relaxed)};
+  auto &event{buffer.events.at(head % bufferCapacity)};
+  event.name.store(name, std::memory_order_relaxed);
+  event.start.store(start, std::memory_order_relaxed);
+  event.end.store(end, std::memory_order_relaxed);
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Writes the recorded events to a file in the Chrome trace event
+ * format.
+ *
+ * Events remain recorded, so subsequent calls write them again, together
+ * with the events recorded in between.
+ *
+ * @param path Path of the JSON file.
+ *
+ * @throw abcg::Exception if the file could not be written.
+ */
+void abcg::Tracer::writeChromeTrace(std::string_view path) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    const std::lock_guard lock{registryMutex};
+    buffers = registry;
+  }
+
+  std::string trace{R"({"displayTimeUnit": "ms", "traceEvents": [)"};
+  auto separator{""};
+  for (const auto &buffer : buffers) {
+    const auto head{buffer->head.load(std::memory_order_acquire)};
+    const auto first{head - std::min<std::uint64_t>(head, bufferCapacity)};
+
+    std::vector<std::array<std::int64_t, 2>> times;
+    std::vector<const char *> names;
+    for (auto index{first}; index < head; ++index) {
+      const auto &event{buffer->events.at(index % bufferCapacity)};
+      names.push_back(event.name.load(std::memory_order_relaxed));
+      times.push_back({event.start.load(std::memory_order_relaxed),
+                       event.end.load(std::memory_order_relaxed)});
+    }
+
+    // Skip the events that the thread may have overwritten while they were
+    // being read
+    const auto newHead{buffer->head.load(std::memory_order_acquire)};
+    const auto valid{newHead + 1 > bufferCapacity
+                         ? newHead + 1 - bufferCapacity
+                         : std::uint64_t{}};
+    for (auto index{std::max(first, valid)}; index < head; ++index) {
+      const auto &[start, end]{times.at(index - first)};
+      trace += fmt::format(
+          R"({}{{"name": "{}", "ph": "X", "ts": {:.3f}, "dur": {:.3f}, )"
+          R"("pid": 1, "tid": {}}})",
+          separator, escapeJSON(names.at(index - first)),
+          static_cast<double>(start) * 1e-3,
+          static_cast<double>(end - start) * 1e-3, buffer->threadId);
+      separator = ",\n";
+    }
+  }
+  trace += "]}\n";
+
+  if (std::ofstream file{std::string{path}}; !(file << trace)) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Failed to write trace to {}", path))};
+  }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file abcg_tracer.hpp
+ * @brief abcg::Tracer header file.
+ *
+ * Declaration of abcg::Tracer class and ABCG_TRACE_SCOPE macro.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_TRACER_HPP_
+#define ABCG_TRACER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace abcg {
+class Tracer;
+}  // namespace abcg
+
+#define ABCG_TRACE_CONCAT_(a, b) a##b
+#define ABCG_TRACE_CONCAT(a, b) ABCG_TRACE_CONCAT_(a, b)
+
+/**
+ * @brief Records the CPU time spent until the end of the enclosing scope.
+ *
+ * The name must be a string literal, or a string that outlives the trace.
+ * Has no effect other than reading a flag if tracing is disabled.
+ */
+#define ABCG_TRACE_SCOPE(name)                        \
+  const abcg::Tracer::Scope ABCG_TRACE_CONCAT(        \
+      abcgTraceScope, __LINE__) {                     \
+    name                                              \
+  }
+
+/**
+ * @brief abcg::Tracer class.
+ *
+ * Records scoped CPU events of all threads and writes them in the Chrome
+ * trace event format, which can be opened with chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ * Each thread records into its own ring buffer of bufferCapacity events, so
+ * recording takes no locks. When a buffer is full, the oldest events are
+ * overwritten.
+ *
+ * Tracing is disabled by default. abcg::Application enables it with the
+ * `--trace` command-line option or the F10 key.
+ */
+class abcg::Tracer {
+ public:
+  /** @brief Maximum number of events kept per thread. */
+  static constexpr std::size_t bufferCapacity{16384};
+
+  class Scope;
+
+  Tracer() = delete;
+
+  [[nodiscard]] static bool isEnabled() noexcept {
+    return m_enabled.load(std::memory_order_relaxed);
+  }
+  static void setEnabled(bool enabled) noexcept {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] static std::int64_t now() noexcept;
+  static void record(const char* name, std::int64_t start,
+                     std::int64_t end) noexcept;
+  static void writeChromeTrace(std::string_view path);
+
+ private:
+  static inline std::atomic<bool> m_enabled{};
+};
+
+/**
+ * @brief Records an event from construction to destruction, if tracing is
+ * enabled at construction.
+ */
+class abcg::Tracer::Scope {
+ public:
+  explicit Scope(const char* name) noexcept {
+    if (isEnabled()) {
+      m_name = name;
+      m_start = now();
+    }
+  }
+  ~Scope() {
+    if (m_name != nullptr) record(m_name, m_start, now());
+  }
+
+  Scope(const Scope&) = delete;
+  Scope(Scope&&) = delete;
+  Scope& operator=(const Scope&) = delete;
+  Scope& operator=(Scope&&) = delete;
+
+ private:
+  const char* m_name{};
+  std::int64_t m_start{};
+};
+
+#endif
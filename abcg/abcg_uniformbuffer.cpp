@@ -0,0 +1,66 @@
+/**
+ * @file abcg_uniformbuffer.cpp
+ * @brief Definition of abcg::UniformBuffer class members.
+ *
+ * This project is released under the MIT License.
+ */
+
+#include "abcg_uniformbuffer.hpp"
+
+#include <fmt/core.h>
+
+#include "abcg_exception.hpp"
+#include "abcg_openglfunctions.hpp"
+
+/**
+ * @brief Creates the buffer object and attaches it to a binding point.
+ *
+ * Any buffer previously created by this object is destroyed.
+ *
+ * @param size Size of the buffer in bytes.
+ * @param binding Uniform block binding point.
+ */
+void abcg::UniformBuffer::create(GLsizeiptr size, GLuint binding) {
+  destroy();
+
+  glGenBuffers(1, &m_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_buffer);
+
+  m_binding = binding;
+  m_size = size;
+}
+
+/**
+ * @brief Deletes the buffer object.
+ */
+void abcg::UniformBuffer::destroy() {
+  if (m_buffer == 0) return;
+  glDeleteBuffers(1, &m_buffer);
+  m_buffer = 0;
+  m_size = 0;
+}
+
+/**
+ * @brief Updates a range of the buffer.
+ *
+ * @param data Pointer to the new data.
+ * @param size Size of the range in bytes.
+ * @param offset Offset of the range in bytes.
+ */
+void abcg::UniformBuffer::update(const void *data, GLsizeiptr size,
+                                 GLintptr offset) const {
+  if (offset < 0 || offset + size > m_size) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Uniform buffer update of {} bytes at offset {} exceeds "
+                    "buffer size of {} bytes",
+                    size, offset, m_size))};
+  }
+
+  glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file abcg_uniformbuffer.hpp
+ * @brief abcg::UniformBuffer header file.
+ *
+ * Declaration of abcg::FrameUniforms and abcg::UniformBuffer.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_UNIFORMBUFFER_HPP_
+#define ABCG_UNIFORMBUFFER_HPP_
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+struct FrameUniforms;
+class UniformBuffer;
+}  // namespace abcg
+
+/**
+ * @brief Camera and light state shared by all programs in a frame.
+ *
+ * Matches the following std140 uniform block:
+ *
+ * @code
+ * layout(std140) uniform FrameUniforms {
+ *   highp mat4 viewMatrix;
+ *   highp mat4 projMatrix;
+ *   highp vec4 lightDirWorldSpace;
+ *   highp vec4 Ia, Id, Is;
+ * };
+ * @endcode
+ *
+ * The members are declared highp because a block shared by the vertex and
+ * fragment shaders must have the same precisions in both, and on OpenGL ES
+ * the fragment shader defaults to mediump.
+ *
+ * Programs created with abcg::OpenGLWindow::createProgramFromFile or
+ * abcg::OpenGLWindow::createProgramFromString that declare this block have it
+ * bound to abcg::FrameUniforms::binding.
+ */
+struct abcg::FrameUniforms {
+  /** @brief Uniform block binding point shared by all programs. */
+  static constexpr GLuint binding{0};
+  /** @brief Name of the uniform block in GLSL. */
+  static constexpr const char* blockName{"FrameUniforms"};
+
+  glm::mat4 viewMatrix{1.0f};
+  glm::mat4 projMatrix{1.0f};
+  glm::vec4 lightDirWorldSpace{};
+  glm::vec4 Ia{};
+  glm::vec4 Id{};
+  glm::vec4 Is{};
+};
+
+// Only mat4 and vec4 members, so the std140 layout has no padding
+static_assert(sizeof(abcg::FrameUniforms) == 2 * 64 + 4 * 16);
+
+/**
+ * @brief abcg::UniformBuffer class.
+ *
+ * Uniform buffer object attached to a uniform block binding point.
+ *
+ * The buffer is updated with a single glBufferSubData call, and every
+ * program whose block is bound to the same binding point reads the new
+ * contents without further uniform calls.
+ */
+class abcg::UniformBuffer {
+ public:
+  void create(GLsizeiptr size, GLuint binding);
+  void destroy();
+
+  void update(const void* data, GLsizeiptr size, GLintptr offset = 0) const;
+
+  /**
+   * @brief Replaces the contents of the buffer with a block structure.
+   *
+   * @param data Data laid out according to std140 rules.
+   */
+  template <typename T>
+  void update(const T& data) const {
+    update(&data, sizeof(T));
+  }
+
+  [[nodiscard]] GLuint getId() const noexcept { return m_buffer; }
+  [[nodiscard]] GLuint getBinding() const noexcept { return m_binding; }
+
+ private:
+  GLuint m_buffer{};
+  GLuint m_binding{};
+  GLsizeiptr m_size{};
+};
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * @file abcg_vertexwelder.hpp
+ * @brief abcg::VertexWelder header file.
+ *
+ * Declaration and definition of abcg::VertexHash and abcg::VertexWelder.
+ *
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_VERTEXWELDER_HPP_
+#define ABCG_VERTEXWELDER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "abcg_external.hpp"
+
+namespace abcg {
+template <typename T>
+struct VertexHash;
+template <typename T, typename Hash = VertexHash<T>>
+class VertexWelder;
+}  // namespace abcg
+
+/**
+ * @brief Hash function for plain vertex structures.
+ *
+ * Hashes the object representation of the vertex as a sequence of 32-bit
+ * words. Each word is mixed into the state with a multiply-xorshift step, and
+ * the result goes through the MurmurHash3 64-bit finalizer, so that vertices
+ * that differ only by symmetry (e.g., swapped or negated coordinates) do not
+ * collide.
+ *
+ * Negative zero is hashed as positive zero, as both compare equal.
+ *
+ * @tparam T Vertex type. Must be trivially copyable, made of 32-bit fields
+ * (e.g., float, glm::vec3), and without padding.
+ */
+template <typename T>
+struct abcg::VertexHash {
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(sizeof(T) % sizeof(std::uint32_t) == 0);
+
+  [[nodiscard]] std::uint64_t operator()(const T &vertex) const noexcept {
+    std::array<std::uint32_t, sizeof(T) / sizeof(std::uint32_t)> words{};
+    std::memcpy(words.data(), &vertex, sizeof(T));
+
+    std::uint64_t hash{0x9E3779B97F4A7C15ULL};
+    for (auto word : words) {
+      if (word == 0x80000000U) word = 0;  // -0.0f
+      hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+      hash ^= hash >> 31U;
+    }
+
+    hash ^= hash >> 33U;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33U;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33U;
+    return hash;
+  }
+};
+
+/**
+ * @brief abcg::VertexWelder class.
+ *
+ * Merges duplicate vertices while building an indexed mesh.
+ *
+ * Unique vertices are appended to a vertex array owned by the caller. An
+ * open-addressing hash table with linear probing maps each vertex to its
+ * index in that array. Each slot stores the vertex index and 32 bits of its
+ * hash, so a lookup compares vertices only on a hash match, and a single
+ * probe sequence both finds and inserts a vertex.
+ *
+ * Vertex equality is given by T::operator==.
+ *
+ * @tparam T Vertex type.
+ * @tparam Hash Hash function object type returning a 64-bit hash.
+ */
+template <typename T, typename Hash>
+class abcg::VertexWelder {
+ public:
+  explicit VertexWelder(std::vector<T> &vertices,
+                        std::size_t expectedCount = 0);
+
+  [[nodiscard]] GLuint insert(const T &vertex);
+  void reserve(std::size_t count);
+
+ private:
+  static constexpr GLuint m_emptySlot{~GLuint{}};
+
+  struct Slot {
+    std::uint32_t hash{};
+    GLuint index{m_emptySlot};
+  };
+
+  void place(std::uint32_t hash, GLuint index);
+  void rehash(std::size_t capacity);
+
+  std::vector<T> &m_vertices;
+  std::vector<Slot> m_slots;
+  std::size_t m_mask{};
+  Hash m_hash{};
+};
+
+/**
+ * @brief Constructs an abcg::VertexWelder that appends to a vertex array.
+ *
+ * Vertices already in the array are indexed, so that the array can be
+ * extended across multiple welders. After construction, the array must only
+ * be modified through insert().
+ *
+ * @param vertices Array of unique vertices.
+ * @param expectedCount Expected number of unique vertices. Used to size the
+ * table up front and avoid rehashing.
+ */
+template <typename T, typename Hash>
+abcg::VertexWelder<T, Hash>::VertexWelder(std::vector<T> &vertices,
+                                          std::size_t expectedCount)
+    : m_vertices{vertices} {
+  reserve(std::max(expectedCount, vertices.size()));
+  for (GLuint index{}; index < m_vertices.size(); ++index) {
+    place(static_cast<std::uint32_t>(m_hash(m_vertices[index])), index);
+  }
+}
+
+/**
+ * @brief Returns the index of a vertex, inserting it if it is new.
+ *
+ * @param vertex Vertex to be looked up.
+ * @return Index of the vertex in the vertex array.
+ */
+template <typename T, typename Hash>
+GLuint abcg::VertexWelder<T, Hash>::insert(const T &vertex) {
+  // Keep the load factor at or below 1/2
+  if ((m_vertices.size() + 1) * 2 > m_slots.size()) {
+    rehash(m_slots.size() * 2);
+  }
+
+  const auto hash{static_cast<std::uint32_t>(m_hash(vertex))};
+  for (auto pos{hash & m_mask};; pos = (pos + 1) & m_mask) {
+    auto &slot{m_slots[pos]};
+    if (slot.index == m_emptySlot) {
+      slot = {hash, static_cast<GLuint>(m_vertices.size())};
+      m_vertices.push_back(vertex);
+      return slot.index;
+    }
+    if (slot.hash == hash && m_vertices[slot.index] == vertex) {
+      return slot.index;
+    }
+  }
+}
+
+/**
+ * @brief Reserves space for a number of unique vertices.
+ *
+ * @param count Number of unique vertices.
+ */
+template <typename T, typename Hash>
+void abcg::VertexWelder<T, Hash>::reserve(std::size_t count) {
+  m_vertices.reserve(count);
+
+  std::size_t capacity{64};
+  while (capacity < count * 2) capacity *= 2;
+  if (capacity > m_slots.size()) rehash(capacity);
+}
+
+template <typename T, typename Hash>
+void abcg::VertexWelder<T, Hash>::place(std::uint32_t hash, GLuint index) {
+  for (auto pos{hash & m_mask};; pos = (pos + 1) & m_mask) {
+    auto &slot{m_slots[pos]};
+    if (slot.index == m_emptySlot) {
+      slot = {hash, index};
+      return;
+    }
+  }
+}
+
+template <typename T, typename Hash>
+void abcg::VertexWelder<T, Hash>::rehash(std::size_t capacity) {
+  auto oldSlots{std::move(m_slots)};
+  m_slots.assign(capacity, Slot{});
+  m_mask = capacity - 1;
+  for (const auto &slot : oldSlots) {
+    if (slot.index != m_emptySlot) place(slot.hash, slot.index);
+  }
+}
+
+#endif
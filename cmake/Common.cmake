@@ -68,6 +68,10 @@ if(ENABLE_IPO)
 
 endif()
 
+# OpenGL state cache
+option(ABCG_GL_STATE_CACHE "Skip redundant OpenGL state changes and count them"
+       OFF)
+
 # Conan
 option(ENABLE_CONAN "Use Conan Package Manager" OFF)
 if(ENABLE_CONAN AND NOT ${CMAKE_SYSTEM_NAME} MATCHES "Emscripten")
@@ -0,0 +1,28 @@
+#version 410
+
+layout(location = 0) in vec2 inPosition;
+
+// Per-asteroid attributes, advanced once every 9 instances
+layout(location = 1) in vec4 inColor;
+layout(location = 2) in vec2 inTranslation;
+layout(location = 3) in float inRotation;
+layout(location = 4) in float inScale;
+
+out vec4 fragColor;
+
+// Wrap-around offsets, as explained in objects.vert
+const float wrapOffsets[3] = float[3](0.0, -2.0, 2.0);
+
+void main() {
+  float sinAngle = sin(inRotation);
+  float cosAngle = cos(inRotation);
+  vec2 rotated = vec2(inPosition.x * cosAngle - inPosition.y * sinAngle,
+                      inPosition.x * sinAngle + inPosition.y * cosAngle);
+
+  int copy = gl_InstanceID % 9;
+  vec2 wrapOffset = vec2(wrapOffsets[copy % 3], wrapOffsets[copy / 3]);
+
+  vec2 newPosition = rotated * inScale + inTranslation + wrapOffset;
+  gl_Position = vec4(newPosition, 0, 1);
+  fragColor = inColor;
+}
\ No newline at end of file
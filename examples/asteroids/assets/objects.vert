@@ -9,13 +9,22 @@ uniform vec2 translation;
 
 out vec4 fragColor;
 
+// Objects are drawn as 9 instances, one per screen of the 3x3 grid centered
+// on the visible one, so that an object crossing an edge also shows up on the
+// opposite edge. Instance i is offset by wrapOffsets[i % 3] horizontally and
+// wrapOffsets[i / 3] vertically; instance 0 is the original position
+const float wrapOffsets[3] = float[3](0.0, -2.0, 2.0);
+
 void main() {
   float sinAngle = sin(rotation);
   float cosAngle = cos(rotation);
   vec2 rotated = vec2(inPosition.x * cosAngle - inPosition.y * sinAngle,
                       inPosition.x * sinAngle + inPosition.y * cosAngle);
 
-  vec2 newPosition = rotated * scale + translation;
+  vec2 wrapOffset = vec2(wrapOffsets[gl_InstanceID % 3],
+                         wrapOffsets[gl_InstanceID / 3]);
+
+  vec2 newPosition = rotated * scale + translation + wrapOffset;
   gl_Position = vec4(newPosition, 0, 1);
   fragColor = color;
 }
\ No newline at end of file
@@ -8,8 +8,13 @@ uniform float pointSize;
 
 out vec4 fragColor;
 
+// Wrap-around offsets, as explained in objects.vert
+const float wrapOffsets[3] = float[3](0.0, -2.0, 2.0);
+
 void main() {
+  vec2 wrapOffset = vec2(wrapOffsets[gl_InstanceID % 3],
+                         wrapOffsets[gl_InstanceID / 3]);
   gl_PointSize = pointSize;
-  gl_Position = vec4(inPosition.xy + translation, 0, 1);
+  gl_Position = vec4(inPosition.xy + translation + wrapOffset, 0, 1);
   fragColor = vec4(inColor, 1);
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #include "asteroids.hpp"
 
 #include <cppitertools/itertools.hpp>
+#include <cstddef>
 #include <glm/gtx/fast_trigonometry.hpp>
 
+#include "entitypool.hpp"
+
 void Asteroids::initializeGL(GLuint program, int quantity) {
   terminateGL();
 
@@ -11,133 +14,232 @@ void Asteroids::initializeGL(GLuint program, int quantity) {
   m_randomEngine.seed(seed);
 
   m_program = program;
-  m_colorLoc = glGetUniformLocation(m_program, "color");
-  m_rotationLoc = glGetUniformLocation(m_program, "rotation");
-  m_scaleLoc = glGetUniformLocation(m_program, "scale");
-  m_translationLoc = glGetUniformLocation(m_program, "translation");
 
-  // Create asteroids
-  m_asteroids.clear();
-  m_asteroids.resize(quantity);
+  // Create shapes, packed one after the other into a single VBO
+  auto &re{m_randomEngine};  // Shortcut
+  std::vector<glm::vec2> positions(0);
+  for (auto &shape : m_shapes) {
+    // Randomly choose the number of sides
+    std::uniform_int_distribution<int> randomSides(6, 20);
+    auto polygonSides{randomSides(re)};
+
+    shape.m_first = static_cast<GLint>(positions.size());
+    positions.emplace_back(0, 0);
+    auto step{M_PI * 2 / polygonSides};
+    std::uniform_real_distribution<float> randomRadius(0.8f, 1.0f);
+    for (auto angle : iter::range(0.0, M_PI * 2, step)) {
+      auto radius{randomRadius(re)};
+      positions.emplace_back(radius * std::cos(angle),
+                             radius * std::sin(angle));
+    }
+    positions.push_back(positions.at(shape.m_first + 1));
+    shape.m_vertexCount =
+        static_cast<GLsizei>(positions.size()) - shape.m_first;
+  }
+
+  // Generate VBO
+  glGenBuffers(1, &m_vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
+               positions.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Instance VBO, filled by paintGL
+  glGenBuffers(1, &m_instanceVBO);
+
+  // Get location of attributes in the program
+  GLint positionAttribute{glGetAttribLocation(m_program, "inPosition")};
+
+  // Create VAO
+  glGenVertexArrays(1, &m_vao);
+
+  // Bind vertex attributes to current VAO
+  glBindVertexArray(m_vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  glEnableVertexAttribArray(positionAttribute);
+  glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+  // Per-instance attributes are pointed at the instances of each shape in
+  // paintGL. Each asteroid is drawn as 9 instances, one per wrap-around copy
+  m_colorAttribute = glGetAttribLocation(m_program, "inColor");
+  m_translationAttribute = glGetAttribLocation(m_program, "inTranslation");
+  m_rotationAttribute = glGetAttribLocation(m_program, "inRotation");
+  m_scaleAttribute = glGetAttribLocation(m_program, "inScale");
+  for (auto location : {m_colorAttribute, m_translationAttribute,
+                        m_rotationAttribute, m_scaleAttribute}) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 9);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // End of binding to current VAO
+  glBindVertexArray(0);
 
-  for (auto &asteroid : m_asteroids) {
-    asteroid = createAsteroid();
+  // Create asteroids. Each one breaks into 3 fragments twice, so there are
+  // never more than 9 per initial asteroid, plus the fragments of one
+  // asteroid while it is being replaced
+  clear();
+  reserve(static_cast<std::size_t>(quantity) * 9 + 2);
 
+  for ([[maybe_unused]] auto index : iter::range(quantity)) {
     // Make sure the asteroid won't collide with the ship
+    glm::vec2 translation{};
     do {
-      asteroid.m_translation = {m_randomDist(m_randomEngine),
-                                m_randomDist(m_randomEngine)};
-    } while (glm::length(asteroid.m_translation) < 0.5f);
+      translation = {m_randomDist(re), m_randomDist(re)};
+    } while (glm::length(translation) < 0.5f);
+
+    createAsteroid(translation);
   }
 }
 
-void Asteroids::paintGL() {
-  glUseProgram(m_program);
-
-  for (auto &asteroid : m_asteroids) {
-    glBindVertexArray(asteroid.m_vao);
+void Asteroids::paintGL(float alpha) {
+  if (size() == 0) return;
 
-    glUniform4fv(m_colorLoc, 1, &asteroid.m_color.r);
-    glUniform1f(m_scaleLoc, asteroid.m_scale);
-    glUniform1f(m_rotationLoc, asteroid.m_rotation);
+  // Group the asteroids by shape with a counting sort, so that each shape is
+  // drawn with a single instanced call
+  m_shapeStarts.fill(0);
+  for (auto shapeIndex : m_shapeIndices) {
+    ++m_shapeStarts.at(shapeIndex + 1);
+  }
+  for (auto shapeIndex{1U}; shapeIndex < m_shapeStarts.size(); ++shapeIndex) {
+    m_shapeStarts.at(shapeIndex) += m_shapeStarts.at(shapeIndex - 1);
+  }
 
-    for (auto i : {-2, 0, 2}) {
-      for (auto j : {-2, 0, 2}) {
-        glUniform2f(m_translationLoc, asteroid.m_translation.x + j,
-                    asteroid.m_translation.y + i);
+  auto cursors{m_shapeStarts};
+  m_instanceAttributes.resize(size());
+  for (auto index : iter::range(size())) {
+    // Interpolate between the last two simulation steps
+    m_instanceAttributes.at(cursors.at(m_shapeIndices[index])++) = {
+        .color = m_colors[index],
+        .translation = glm::mix(m_previousTranslations[index],
+                                m_translations[index], alpha),
+        .rotation =
+            glm::mix(m_previousRotations[index], m_rotations[index], alpha),
+        .scale = m_scales[index]};
+  }
 
-        glDrawArrays(GL_TRIANGLE_FAN, 0, asteroid.m_polygonSides + 2);
-      }
-    }
+  // Orphan the previous contents so that the upload does not wait for draws
+  // still reading them
+  glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER,
+               sizeof(m_instanceAttributes[0]) * m_instanceAttributes.size(),
+               m_instanceAttributes.data(), GL_STREAM_DRAW);
 
-    glBindVertexArray(0);
+  glUseProgram(m_program);
+  glBindVertexArray(m_vao);
+
+  for (auto &&[shapeIndex, shape] : iter::enumerate(m_shapes)) {
+    const auto first{m_shapeStarts.at(shapeIndex)};
+    const auto count{m_shapeStarts.at(shapeIndex + 1) - first};
+    if (count == 0) continue;
+
+    // OpenGL 4.1 and ES 3.0 have no base instance, so the per-instance
+    // attributes are pointed at the first instance of the shape instead
+    const auto bindInstanceAttribute{[first](GLint location, GLint size,
+                                             std::size_t offset) {
+      const auto start{first * sizeof(InstanceAttributes) + offset};
+      glVertexAttribPointer(location, size, GL_FLOAT, GL_FALSE,
+                            sizeof(InstanceAttributes),
+                            reinterpret_cast<void *>(start));
+    }};
+    bindInstanceAttribute(m_colorAttribute, 4,
+                          offsetof(InstanceAttributes, color));
+    bindInstanceAttribute(m_translationAttribute, 2,
+                          offsetof(InstanceAttributes, translation));
+    bindInstanceAttribute(m_rotationAttribute, 1,
+                          offsetof(InstanceAttributes, rotation));
+    bindInstanceAttribute(m_scaleAttribute, 1,
+                          offsetof(InstanceAttributes, scale));
+
+    // 9 instances per asteroid (see wrapOffsets in objects.vert)
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, shape.m_first, shape.m_vertexCount,
+                          static_cast<GLsizei>(count * 9));
   }
 
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
   glUseProgram(0);
 }
 
 void Asteroids::terminateGL() {
-  for (auto asteroid : m_asteroids) {
-    glDeleteBuffers(1, &asteroid.m_vbo);
-    glDeleteVertexArrays(1, &asteroid.m_vao);
-  }
+  glDeleteBuffers(1, &m_instanceVBO);
+  glDeleteBuffers(1, &m_vbo);
+  glDeleteVertexArrays(1, &m_vao);
+  m_instanceVBO = 0;
+  m_vbo = 0;
+  m_vao = 0;
 }
 
 void Asteroids::update(const Ship &ship, float deltaTime) {
-  for (auto &asteroid : m_asteroids) {
-    asteroid.m_translation -= ship.m_velocity * deltaTime;
-    asteroid.m_rotation = glm::wrapAngle(
-        asteroid.m_rotation + asteroid.m_angularVelocity * deltaTime);
-    asteroid.m_translation += asteroid.m_velocity * deltaTime;
-
-    // Wrap-around
-    if (asteroid.m_translation.x < -1.0f) asteroid.m_translation.x += 2.0f;
-    if (asteroid.m_translation.x > +1.0f) asteroid.m_translation.x -= 2.0f;
-    if (asteroid.m_translation.y < -1.0f) asteroid.m_translation.y += 2.0f;
-    if (asteroid.m_translation.y > +1.0f) asteroid.m_translation.y -= 2.0f;
+  for (auto index : iter::range(size())) {
+    auto &translation{m_translations[index]};
+    auto &rotation{m_rotations[index]};
+    m_previousRotations[index] = rotation;
+    m_previousTranslations[index] = translation;
+
+    translation -= ship.m_velocity * deltaTime;
+    auto newRotation{rotation + m_angularVelocities[index] * deltaTime};
+    rotation = glm::wrapAngle(newRotation);
+    translation += m_velocities[index] * deltaTime;
+
+    // Wrap-around. The previous state is wrapped along, so that the
+    // interpolation does not cross the screen
+    glm::vec2 wrap{0};
+    if (translation.x < -1.0f) wrap.x += 2.0f;
+    if (translation.x > +1.0f) wrap.x -= 2.0f;
+    if (translation.y < -1.0f) wrap.y += 2.0f;
+    if (translation.y > +1.0f) wrap.y -= 2.0f;
+    translation += wrap;
+    m_previousTranslations[index] += wrap;
+    m_previousRotations[index] += rotation - newRotation;
   }
 }
 
-Asteroids::Asteroid Asteroids::createAsteroid(glm::vec2 translation,
-                                              float scale) {
-  Asteroid asteroid;
-
+void Asteroids::createAsteroid(glm::vec2 translation, float scale) {
   auto &re{m_randomEngine};  // Shortcut
 
-  // Randomly choose the number of sides
-  std::uniform_int_distribution<int> randomSides(6, 20);
-  asteroid.m_polygonSides = randomSides(re);
+  // Randomly choose one of the shapes
+  std::uniform_int_distribution<std::size_t> randomShape(0,
+                                                         m_shapes.size() - 1);
+  m_shapeIndices.push_back(randomShape(re));
 
   // Choose a random color (actually, a grayscale)
   std::uniform_real_distribution<float> randomIntensity(0.5f, 1.0f);
-  asteroid.m_color = glm::vec4(1) * randomIntensity(re);
+  glm::vec4 color{glm::vec4(1) * randomIntensity(re)};
+  color.a = 1.0f;
+  m_colors.push_back(color);
 
-  asteroid.m_color.a = 1.0f;
-  asteroid.m_rotation = 0.0f;
-  asteroid.m_scale = scale;
-  asteroid.m_translation = translation;
+  m_hits.push_back(0);
+  m_rotations.push_back(0.0f);
+  m_previousRotations.push_back(0.0f);
+  m_scales.push_back(scale);
+  m_translations.push_back(translation);
+  m_previousTranslations.push_back(translation);
 
   // Choose a random angular velocity
-  asteroid.m_angularVelocity = m_randomDist(re);
+  m_angularVelocities.push_back(m_randomDist(re));
 
   // Choose a random direction
   glm::vec2 direction{m_randomDist(re), m_randomDist(re)};
-  asteroid.m_velocity = glm::normalize(direction) / 7.0f;
-
-  // Create geometry
-  std::vector<glm::vec2> positions(0);
-  positions.emplace_back(0, 0);
-  auto step{M_PI * 2 / asteroid.m_polygonSides};
-  std::uniform_real_distribution<float> randomRadius(0.8f, 1.0f);
-  for (auto angle : iter::range(0.0, M_PI * 2, step)) {
-    auto radius{randomRadius(re)};
-    positions.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
-  }
-  positions.push_back(positions.at(1));
-
-  // Generate VBO
-  glGenBuffers(1, &asteroid.m_vbo);
-  glBindBuffer(GL_ARRAY_BUFFER, asteroid.m_vbo);
-  glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
-               positions.data(), GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  // Get location of attributes in the program
-  GLint positionAttribute{glGetAttribLocation(m_program, "inPosition")};
-
-  // Create VAO
-  glGenVertexArrays(1, &asteroid.m_vao);
-
-  // Bind vertex attributes to current VAO
-  glBindVertexArray(asteroid.m_vao);
+  m_velocities.push_back(glm::normalize(direction) / 7.0f);
+}
 
-  glBindBuffer(GL_ARRAY_BUFFER, asteroid.m_vbo);
-  glEnableVertexAttribArray(positionAttribute);
-  glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+void Asteroids::removeAsteroid(std::size_t index) {
+  removeEntity(index, m_angularVelocities, m_colors, m_hits,
+               m_previousRotations, m_previousTranslations, m_rotations,
+               m_scales, m_shapeIndices, m_translations, m_velocities);
+}
 
-  // End of binding to current VAO
-  glBindVertexArray(0);
+void Asteroids::reserve(std::size_t capacity) {
+  reserveEntities(capacity, m_angularVelocities, m_colors, m_hits,
+                  m_previousRotations, m_previousTranslations, m_rotations,
+                  m_scales, m_shapeIndices, m_translations, m_velocities);
+}
 
-  return asteroid;
-}
\ No newline at end of file
+void Asteroids::clear() {
+  clearEntities(m_angularVelocities, m_colors, m_hits, m_previousRotations,
+                m_previousTranslations, m_rotations, m_scales,
+                m_shapeIndices, m_translations, m_velocities);
+}
@@ -1,8 +1,10 @@
 #ifndef ASTEROIDS_HPP_
 #define ASTEROIDS_HPP_
 
-#include <list>
+#include <array>
+#include <cstdint>
 #include <random>
+#include <vector>
 
 #include "abcg.hpp"
 #include "gamedata.hpp"
@@ -13,7 +15,7 @@ class OpenGLWindow;
 class Asteroids {
  public:
   void initializeGL(GLuint program, int quantity);
-  void paintGL();
+  void paintGL(float alpha);
   void terminateGL();
 
   void update(const Ship &ship, float deltaTime);
@@ -22,32 +24,58 @@ class Asteroids {
   friend OpenGLWindow;
 
   GLuint m_program{};
-  GLint m_colorLoc{};
-  GLint m_rotationLoc{};
-  GLint m_translationLoc{};
-  GLint m_scaleLoc{};
-
-  struct Asteroid {
-    GLuint m_vao{};
-    GLuint m_vbo{};
-
-    float m_angularVelocity{};
-    glm::vec4 m_color{1};
-    bool m_hit{false};
-    int m_polygonSides{};
-    float m_rotation{};
-    float m_scale{};
-    glm::vec2 m_translation{glm::vec2(0)};
-    glm::vec2 m_velocity{glm::vec2(0)};
+  GLuint m_vao{};
+  GLuint m_vbo{};
+  GLuint m_instanceVBO{};
+  GLint m_colorAttribute{};
+  GLint m_translationAttribute{};
+  GLint m_rotationAttribute{};
+  GLint m_scaleAttribute{};
+
+  // Random polygons shared by the asteroids, packed into m_vbo when
+  // initializeGL is called, so that spawning asteroids creates no OpenGL
+  // objects
+  struct Shape {
+    GLint m_first{};
+    GLsizei m_vertexCount{};
+  };
+
+  std::array<Shape, 16> m_shapes{};
+
+  // Layout of the per-asteroid attributes in m_instanceVBO
+  struct InstanceAttributes {
+    glm::vec4 color;
+    glm::vec2 translation;
+    float rotation;
+    float scale;
   };
+  std::vector<InstanceAttributes> m_instanceAttributes;
+  // Instances of shape s are in [m_shapeStarts[s], m_shapeStarts[s + 1])
+  std::array<std::size_t, 17> m_shapeStarts{};
 
-  std::list<Asteroid> m_asteroids;
+  // Asteroids stored as a structure of arrays: element i of each array
+  // belongs to asteroid i. Removing an asteroid moves the last one into its
+  // place
+  std::vector<float> m_angularVelocities;
+  std::vector<glm::vec4> m_colors;
+  std::vector<std::uint8_t> m_hits;
+  std::vector<float> m_previousRotations;
+  std::vector<glm::vec2> m_previousTranslations;
+  std::vector<float> m_rotations;
+  std::vector<float> m_scales;
+  std::vector<std::size_t> m_shapeIndices;
+  std::vector<glm::vec2> m_translations;
+  std::vector<glm::vec2> m_velocities;
 
   std::default_random_engine m_randomEngine;
   std::uniform_real_distribution<float> m_randomDist{-1.0f, 1.0f};
 
-  Asteroids::Asteroid createAsteroid(glm::vec2 translation = glm::vec2(0),
-                                     float scale = 0.25f);
+  [[nodiscard]] std::size_t size() const { return m_translations.size(); }
+  void createAsteroid(glm::vec2 translation = glm::vec2(0),
+                      float scale = 0.25f);
+  void removeAsteroid(std::size_t index);
+  void reserve(std::size_t capacity);
+  void clear();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,8 +1,11 @@
 #include "bullets.hpp"
 
+#include <algorithm>
 #include <cppitertools/itertools.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 
+#include "entitypool.hpp"
+
 void Bullets::initializeGL(GLuint program) {
   terminateGL();
 
@@ -12,7 +15,9 @@ void Bullets::initializeGL(GLuint program) {
   m_scaleLoc = glGetUniformLocation(m_program, "scale");
   m_translationLoc = glGetUniformLocation(m_program, "translation");
 
-  m_bullets.clear();
+  clearEntities(m_deads, m_previousTranslations, m_translations, m_velocities);
+  reserveEntities(256, m_deads, m_previousTranslations, m_translations,
+                  m_velocities);
 
   // Create regular polygon
   auto sides{10};
@@ -50,7 +55,7 @@ void Bullets::initializeGL(GLuint program) {
   glBindVertexArray(0);
 }
 
-void Bullets::paintGL() {
+void Bullets::paintGL(float alpha) {
   glUseProgram(m_program);
 
   glBindVertexArray(m_vao);
@@ -58,9 +63,11 @@ void Bullets::paintGL() {
   glUniform1f(m_rotationLoc, 0);
   glUniform1f(m_scaleLoc, m_scale);
 
-  for (auto &bullet : m_bullets) {
-    glUniform2f(m_translationLoc, bullet.m_translation.x,
-                bullet.m_translation.y);
+  for (auto index : iter::range(size())) {
+    // Interpolate between the last two simulation steps
+    const auto translation{glm::mix(m_previousTranslations[index],
+                                    m_translations[index], alpha)};
+    glUniform2f(m_translationLoc, translation.x, translation.y);
 
     glDrawArrays(GL_TRIANGLE_FAN, 0, 12);
   }
@@ -76,12 +83,16 @@ void Bullets::terminateGL() {
 }
 
 void Bullets::update(Ship &ship, const GameData &gameData, float deltaTime) {
+  // The cooldown runs on simulation time, so that it does not depend on the
+  // frame rate
+  ship.m_bulletCoolDown = std::max(ship.m_bulletCoolDown - deltaTime, 0.0f);
+
   // Create a pair of bullets
   if (gameData.m_input[static_cast<size_t>(Input::Fire)] &&
       gameData.m_state == State::Playing) {
     // At least 250 ms must have passed since the last bullets
-    if (ship.m_bulletCoolDownTimer.elapsed() > 250.0 / 1000.0) {
-      ship.m_bulletCoolDownTimer.restart();
+    if (ship.m_bulletCoolDown <= 0.0f) {
+      ship.m_bulletCoolDown = 250.0f / 1000.0f;
 
       // Bullets are shot in the direction of the ship's forward vector
       glm::vec2 forward{glm::rotate(glm::vec2{0.0f, 1.0f}, ship.m_rotation)};
@@ -89,30 +100,44 @@ void Bullets::update(Ship &ship, const GameData &gameData, float deltaTime) {
       auto cannonOffset{(11.0f / 15.5f) * ship.m_scale};
       auto bulletSpeed{2.0f};
 
-      Bullet bullet{.m_dead = false,
-                    .m_translation = ship.m_translation + right * cannonOffset,
-                    .m_velocity = ship.m_velocity + forward * bulletSpeed};
-      m_bullets.push_back(bullet);
-
-      bullet.m_translation = ship.m_translation - right * cannonOffset;
-      m_bullets.push_back(bullet);
+      auto velocity{ship.m_velocity + forward * bulletSpeed};
+      createBullet(ship.m_translation + right * cannonOffset, velocity);
+      createBullet(ship.m_translation - right * cannonOffset, velocity);
 
       // Moves ship in the opposite direction
       ship.m_velocity -= forward * 0.1f;
     }
   }
 
-  for (auto &bullet : m_bullets) {
-    bullet.m_translation -= ship.m_velocity * deltaTime;
-    bullet.m_translation += bullet.m_velocity * deltaTime;
+  for (auto index : iter::range(size())) {
+    auto &translation{m_translations[index]};
+    m_previousTranslations[index] = translation;
+    translation -= ship.m_velocity * deltaTime;
+    translation += m_velocities[index] * deltaTime;
 
     // Kill bullet if it goes off screen
-    if (bullet.m_translation.x < -1.1f) bullet.m_dead = true;
-    if (bullet.m_translation.x > +1.1f) bullet.m_dead = true;
-    if (bullet.m_translation.y < -1.1f) bullet.m_dead = true;
-    if (bullet.m_translation.y > +1.1f) bullet.m_dead = true;
+    if (translation.x < -1.1f) m_deads[index] = 1;
+    if (translation.x > +1.1f) m_deads[index] = 1;
+    if (translation.y < -1.1f) m_deads[index] = 1;
+    if (translation.y > +1.1f) m_deads[index] = 1;
   }
 
-  // Remove dead bullets
-  m_bullets.remove_if([](const Bullet &p) { return p.m_dead; });
+  removeDeadBullets();
+}
+
+void Bullets::createBullet(glm::vec2 translation, glm::vec2 velocity) {
+  m_deads.push_back(0);
+  m_previousTranslations.push_back(translation);
+  m_translations.push_back(translation);
+  m_velocities.push_back(velocity);
+}
+
+void Bullets::removeDeadBullets() {
+  // Backwards, so that the bullet moved into a freed slot was already checked
+  for (auto index{size()}; index-- > 0;) {
+    if (m_deads[index] != 0) {
+      removeEntity(index, m_deads, m_previousTranslations, m_translations,
+                   m_velocities);
+    }
+  }
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #ifndef BULLETS_HPP_
 #define BULLETS_HPP_
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
 #include "abcg.hpp"
 #include "gamedata.hpp"
@@ -12,7 +13,7 @@ class OpenGLWindow;
 class Bullets {
  public:
   void initializeGL(GLuint program);
-  void paintGL();
+  void paintGL(float alpha);
   void terminateGL();
 
   void update(Ship &ship, const GameData &gameData, float deltaTime);
@@ -29,15 +30,18 @@ class Bullets {
   GLuint m_vao{};
   GLuint m_vbo{};
 
-  struct Bullet {
-    bool m_dead{false};
-    glm::vec2 m_translation{glm::vec2(0)};
-    glm::vec2 m_velocity{glm::vec2(0)};
-  };
-
   float m_scale{0.015f};
 
-  std::list<Bullet> m_bullets;
+  // Bullets stored as a structure of arrays: element i of each array belongs
+  // to bullet i. Removing a bullet moves the last one into its place
+  std::vector<std::uint8_t> m_deads;
+  std::vector<glm::vec2> m_previousTranslations;
+  std::vector<glm::vec2> m_translations;
+  std::vector<glm::vec2> m_velocities;
+
+  [[nodiscard]] std::size_t size() const { return m_translations.size(); }
+  void createBullet(glm::vec2 translation, glm::vec2 velocity);
+  void removeDeadBullets();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef ENTITYPOOL_HPP_
+#define ENTITYPOOL_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Helpers for entities stored as a structure of arrays, in which element i
+// of every array belongs to entity i
+
+// Reserves the same capacity in all arrays
+template <typename... Arrays>
+void reserveEntities(std::size_t capacity, Arrays &...arrays) {
+  (arrays.reserve(capacity), ...);
+}
+
+// Removes all entities without releasing capacity
+template <typename... Arrays>
+void clearEntities(Arrays &...arrays) {
+  (arrays.clear(), ...);
+}
+
+// Removes entity index by moving the last entity into its place. The order
+// of the entities is not preserved
+template <typename... Arrays>
+void removeEntity(std::size_t index, Arrays &...arrays) {
+  ((arrays[index] = std::move(arrays.back()), arrays.pop_back()), ...);
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 #include <imgui.h>
 
+#include <cppitertools/itertools.hpp>
+
 #include "abcg.hpp"
 void OpenGLWindow::handleEvent(SDL_Event &event) {
   // Keyboard events
@@ -67,6 +69,10 @@ void OpenGLWindow::initializeGL() {
   m_objectsProgram = createProgramFromFile(getAssetsPath() + "objects.vert",
                                            getAssetsPath() + "objects.frag");
 
+  // Create program to render the asteroids, instanced
+  m_asteroidsProgram = createProgramFromFile(
+      getAssetsPath() + "asteroids.vert", getAssetsPath() + "objects.frag");
+
   // Create program to render the stars
   m_starsProgram = createProgramFromFile(getAssetsPath() + "stars.vert",
                                          getAssetsPath() + "stars.frag");
@@ -89,20 +95,30 @@ void OpenGLWindow::restart() {
 
   m_starLayers.initializeGL(m_starsProgram, 25);
   m_ship.initializeGL(m_objectsProgram);
-  m_asteroids.initializeGL(m_objectsProgram, 3);
+  m_asteroids.initializeGL(m_asteroidsProgram, 3);
   m_bullets.initializeGL(m_objectsProgram);
+
+  m_timestep.reset();
 }
 
 void OpenGLWindow::update() {
-  float deltaTime{static_cast<float>(getDeltaTime())};
+  ABCG_TRACE_SCOPE("update");
 
   // Wait 5 seconds before restarting
   if (m_gameData.m_state != State::Playing &&
-      m_restartWaitTimer.elapsed() > 5) {
+      m_restartWaitTime > 5.0f) {
     restart();
     return;
   }
 
+  m_alpha = static_cast<float>(m_timestep.advance(
+      getDeltaTime(),
+      [this](double deltaTime) { step(static_cast<float>(deltaTime)); }));
+}
+
+void OpenGLWindow::step(float deltaTime) {
+  if (m_gameData.m_state != State::Playing) m_restartWaitTime += deltaTime;
+
   m_ship.update(m_gameData, deltaTime);
   m_starLayers.update(m_ship, deltaTime);
   m_asteroids.update(m_ship, deltaTime);
@@ -120,10 +136,10 @@ void OpenGLWindow::paintGL() {
   glClear(GL_COLOR_BUFFER_BIT);
   glViewport(0, 0, m_viewportWidth, m_viewportHeight);
 
-  m_starLayers.paintGL();
-  m_asteroids.paintGL();
-  m_bullets.paintGL();
-  m_ship.paintGL(m_gameData);
+  m_starLayers.paintGL(m_alpha);
+  m_asteroids.paintGL(m_alpha);
+  m_bullets.paintGL(m_alpha);
+  m_ship.paintGL(m_gameData, m_alpha);
 }
 
 void OpenGLWindow::paintUI() {
@@ -162,6 +178,7 @@ void OpenGLWindow::terminateGL() {
   // Release shader program, VBO and VAO
   glDeleteProgram(m_starsProgram);
   glDeleteProgram(m_objectsProgram);
+  glDeleteProgram(m_asteroidsProgram);
 
   m_asteroids.terminateGL();
   m_bullets.terminateGL();
@@ -170,58 +187,72 @@ void OpenGLWindow::terminateGL() {
 }
 
 void OpenGLWindow::checkCollisions() {
+  ABCG_TRACE_SCOPE("checkCollisions");
+
   // Check collision between ship and asteroids
-  for (auto &asteroid : m_asteroids.m_asteroids) {
-    auto asteroidTranslation{asteroid.m_translation};
+  for (auto index : iter::range(m_asteroids.size())) {
+    auto asteroidTranslation{m_asteroids.m_translations[index]};
     auto distance{glm::distance(m_ship.m_translation, asteroidTranslation)};
 
-    if (distance < m_ship.m_scale * 0.9f + asteroid.m_scale * 0.85f) {
+    if (distance <
+        m_ship.m_scale * 0.9f + m_asteroids.m_scales[index] * 0.85f) {
       m_gameData.m_state = State::GameOver;
-      m_restartWaitTimer.restart();
+      m_restartWaitTime = 0.0f;
     }
   }
 
-  // Check collision between bullets and asteroids
-  for (auto &bullet : m_bullets.m_bullets) {
-    if (bullet.m_dead) continue;
-
-    for (auto &asteroid : m_asteroids.m_asteroids) {
-      for (auto i : {-2, 0, 2}) {
-        for (auto j : {-2, 0, 2}) {
-          auto asteroidTranslation{asteroid.m_translation + glm::vec2(i, j)};
-          auto distance{
-              glm::distance(bullet.m_translation, asteroidTranslation)};
-
-          if (distance < m_bullets.m_scale + asteroid.m_scale * 0.85f) {
-            asteroid.m_hit = true;
-            bullet.m_dead = true;
-          }
-        }
-      }
-    }
+  // Check collision between bullets and asteroids. The radius of each
+  // asteroid in the grid includes the radius of a bullet, so a collision is
+  // an asteroid that contains the center of the bullet. The grid measures
+  // distances the shortest way around the screen, which replaces testing
+  // the 9 wrap-around copies of each asteroid
+  m_spatialHash.clear();
+  for (auto index : iter::range(m_asteroids.size())) {
+    m_spatialHash.insert(
+        index, m_asteroids.m_translations[index],
+        m_asteroids.m_scales[index] * 0.85f + m_bullets.m_scale);
+  }
+  m_spatialHash.build();
+
+  for (auto bulletIndex : iter::range(m_bullets.size())) {
+    if (m_bullets.m_deads[bulletIndex] != 0) continue;
+
+    const auto bulletTranslation{m_bullets.m_translations[bulletIndex]};
+    m_spatialHash.forEachContaining(
+        bulletTranslation, [&](std::size_t index) {
+          // Asteroids already hit in this step are broken below
+          if (m_asteroids.m_hits[index] != 0) return;
 
-    // Break asteroids marked as hit
-    for (auto &asteroid : m_asteroids.m_asteroids) {
-      if (asteroid.m_hit && asteroid.m_scale > 0.10f) {
-        std::uniform_real_distribution<float> m_randomDist{-1.0f, 1.0f};
-        std::generate_n(std::back_inserter(m_asteroids.m_asteroids), 3, [&]() {
-          glm::vec2 offset{m_randomDist(m_randomEngine),
-                           m_randomDist(m_randomEngine)};
-          return m_asteroids.createAsteroid(
-              asteroid.m_translation + offset * asteroid.m_scale * 0.5f,
-              asteroid.m_scale * 0.5f);
+          m_asteroids.m_hits[index] = 1;
+          m_bullets.m_deads[bulletIndex] = 1;
         });
+  }
+
+  // Break asteroids marked as hit. Backwards, so that the asteroid moved
+  // into the slot of a removed one was already checked
+  for (auto index{m_asteroids.size()}; index-- > 0;) {
+    if (m_asteroids.m_hits[index] == 0) continue;
+
+    const auto scale{m_asteroids.m_scales[index]};
+    if (scale > 0.10f) {
+      const auto translation{m_asteroids.m_translations[index]};
+      std::uniform_real_distribution<float> m_randomDist{-1.0f, 1.0f};
+      for ([[maybe_unused]] auto fragment : iter::range(3)) {
+        glm::vec2 offset{m_randomDist(m_randomEngine),
+                         m_randomDist(m_randomEngine)};
+        m_asteroids.createAsteroid(translation + offset * scale * 0.5f,
+                                   scale * 0.5f);
       }
     }
-
-    m_asteroids.m_asteroids.remove_if(
-        [](const Asteroids::Asteroid &a) { return a.m_hit; });
+    m_asteroids.removeAsteroid(index);
   }
+
+  m_bullets.removeDeadBullets();
 }
 
 void OpenGLWindow::checkWinCondition() {
-  if (m_asteroids.m_asteroids.empty()) {
+  if (m_asteroids.size() == 0) {
     m_gameData.m_state = State::Win;
-    m_restartWaitTimer.restart();
+    m_restartWaitTime = 0.0f;
   }
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "asteroids.hpp"
 #include "bullets.hpp"
 #include "ship.hpp"
+#include "spatialhash.hpp"
 #include "starlayers.hpp"
 
 class OpenGLWindow : public abcg::OpenGLWindow {
@@ -23,6 +24,7 @@ class OpenGLWindow : public abcg::OpenGLWindow {
  private:
   GLuint m_starsProgram{};
   GLuint m_objectsProgram{};
+  GLuint m_asteroidsProgram{};
 
   int m_viewportWidth{};
   int m_viewportHeight{};
@@ -34,7 +36,16 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   Ship m_ship;
   StarLayers m_starLayers;
 
-  abcg::ElapsedTimer m_restartWaitTimer;
+  // Broad phase of the collisions between bullets and asteroids
+  SpatialHash m_spatialHash;
+
+  // Simulation time since the game was won or lost, in seconds
+  float m_restartWaitTime{};
+
+  // Simulation runs at 120 steps per second regardless of the frame rate
+  abcg::FixedTimestep m_timestep{120.0};
+  // Interpolation factor between the last two steps
+  float m_alpha{};
 
   ImFont* m_font{};
 
@@ -42,6 +53,7 @@ class OpenGLWindow : public abcg::OpenGLWindow {
 
   void restart();
   void update();
+  void step(float deltaTime);
   void checkCollisions();
   void checkWinCondition();
 
@@ -13,8 +13,10 @@ void Ship::initializeGL(GLuint program) {
   m_translationLoc = glGetUniformLocation(m_program, "translation");
 
   m_rotation = 0.0f;
+  m_previousRotation = 0.0f;
   m_translation = glm::vec2(0);
   m_velocity = glm::vec2(0);
+  m_bulletCoolDown = 0.0f;
 
   std::array<glm::vec2, 24> positions{
       // Ship body
@@ -99,15 +101,16 @@ void Ship::initializeGL(GLuint program) {
   glBindVertexArray(0);
 }
 
-void Ship::paintGL(const GameData &gameData) {
+void Ship::paintGL(const GameData &gameData, float alpha) {
   if (gameData.m_state != State::Playing) return;
 
   glUseProgram(m_program);
 
   glBindVertexArray(m_vao);
 
+  // Interpolate between the last two simulation steps
   glUniform1f(m_scaleLoc, m_scale);
-  glUniform1f(m_rotationLoc, m_rotation);
+  glUniform1f(m_rotationLoc, glm::mix(m_previousRotation, m_rotation, alpha));
   glUniform2fv(m_translationLoc, 1, &m_translation.x);
 
   // Restart thruster blink timer every 100 ms
@@ -143,11 +146,16 @@ void Ship::terminateGL() {
 }
 
 void Ship::update(const GameData &gameData, float deltaTime) {
-  // Rotate
+  // Rotate. The previous rotation is wrapped along, so that the
+  // interpolation does not turn the long way around
+  auto rotation{m_rotation};
   if (gameData.m_input[static_cast<size_t>(Input::Left)])
-    m_rotation = glm::wrapAngle(m_rotation + 4.0f * deltaTime);
+    rotation += 4.0f * deltaTime;
   if (gameData.m_input[static_cast<size_t>(Input::Right)])
-    m_rotation = glm::wrapAngle(m_rotation - 4.0f * deltaTime);
+    rotation -= 4.0f * deltaTime;
+  m_previousRotation = m_rotation;
+  m_rotation = glm::wrapAngle(rotation);
+  m_previousRotation += m_rotation - rotation;
 
   // Apply thrust
   if (gameData.m_input[static_cast<size_t>(Input::Up)] &&
@@ -12,11 +12,14 @@ class StarLayers;
 class Ship {
  public:
   void initializeGL(GLuint program);
-  void paintGL(const GameData &gameData);
+  void paintGL(const GameData &gameData, float alpha);
   void terminateGL();
 
   void update(const GameData &gameData, float deltaTime);
-  void setRotation(float rotation) { m_rotation = rotation; }
+  void setRotation(float rotation) {
+    m_rotation = rotation;
+    m_previousRotation = rotation;
+  }
 
  private:
   friend Asteroids;
@@ -35,13 +38,15 @@ class Ship {
   GLuint m_ebo{};
 
   glm::vec4 m_color{1};
+  float m_previousRotation{};
   float m_rotation{};
   float m_scale{0.125f};
   glm::vec2 m_translation{glm::vec2(0)};
   glm::vec2 m_velocity{glm::vec2(0)};
 
   abcg::ElapsedTimer m_trailBlinkTimer;
-  abcg::ElapsedTimer m_bulletCoolDownTimer;
+  // Simulation time left before the next bullets can be fired, in seconds
+  float m_bulletCoolDown{};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "spatialhash.hpp"
+
+#include <cmath>
+
+SpatialHash::SpatialHash(int maxResolution)
+    : m_maxResolution{std::max(maxResolution, 1)} {
+  clear();
+}
+
+void SpatialHash::clear() {
+  // Keep the capacity, so that rebuilding every step does not allocate
+  m_entries.clear();
+  m_disks.clear();
+  m_maxRadius = 0.0f;
+  m_resolution = 1;
+  m_cellStarts.assign(2, 0);
+}
+
+void SpatialHash::insert(std::size_t item, glm::vec2 center, float radius) {
+  m_entries.push_back({item, center, radius * radius});
+  m_maxRadius = std::max(m_maxRadius, radius);
+}
+
+void SpatialHash::build() {
+  // Finest grid whose cells are not smaller than the largest disk
+  const auto maxResolution{static_cast<float>(m_maxResolution)};
+  const auto resolution{m_maxRadius > 0.0f
+                            ? std::min(2.0f / m_maxRadius, maxResolution)
+                            : maxResolution};
+  m_resolution = std::max(static_cast<int>(resolution), 1);
+
+  // Counting sort of the disks by cell
+  m_cellStarts.assign(m_resolution * m_resolution + 1, 0);
+  for (const auto &disk : m_entries) {
+    ++m_cellStarts[cellOf(disk.center) + 1];
+  }
+  for (auto cell{1U}; cell < m_cellStarts.size(); ++cell) {
+    m_cellStarts[cell] += m_cellStarts[cell - 1];
+  }
+
+  m_disks.resize(m_entries.size());
+  m_cellCursors.assign(m_cellStarts.begin(), m_cellStarts.end());
+  for (const auto &disk : m_entries) {
+    m_disks[m_cellCursors[cellOf(disk.center)]++] = disk;
+  }
+}
+
+glm::vec2 SpatialHash::wrappedDelta(glm::vec2 a, glm::vec2 b) {
+  auto delta{a - b};
+  // Points are at most one world width outside [-1, 1)
+  if (delta.x > 1.0f) delta.x -= 2.0f;
+  if (delta.x < -1.0f) delta.x += 2.0f;
+  if (delta.y > 1.0f) delta.y -= 2.0f;
+  if (delta.y < -1.0f) delta.y += 2.0f;
+  return delta;
+}
+
+int SpatialHash::cellOf(glm::vec2 point) const {
+  return cellCoordinate(point.y) * m_resolution + cellCoordinate(point.x);
+}
+
+int SpatialHash::cellCoordinate(float coordinate) const {
+  const auto scale{0.5f * static_cast<float>(m_resolution)};
+  return wrapCellCoordinate(
+      static_cast<int>(std::floor((coordinate + 1.0f) * scale)));
+}
+
+int SpatialHash::wrapCellCoordinate(int coordinate) const {
+  coordinate %= m_resolution;
+  return coordinate < 0 ? coordinate + m_resolution : coordinate;
+}
@@ -0,0 +1,78 @@
+#ifndef SPATIALHASH_HPP_
+#define SPATIALHASH_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "abcg.hpp"
+
+// Uniform grid over the toroidal world [-1, 1)², used as a broad phase for
+// collision detection against disks. Each disk is stored in the cell of its
+// center, and cells are at least as large as the largest disk, so a disk
+// that contains a point is in the cell of the point or in one of its 8
+// neighbours. Cell indices wrap around the edges of the world
+class SpatialHash {
+ public:
+  explicit SpatialHash(int maxResolution = 64);
+
+  void clear();
+  void insert(std::size_t item, glm::vec2 center, float radius);
+  void build();
+
+  // Calls function(item) for each inserted disk that contains point, taking
+  // wrap-around into account. Must be called after build()
+  template <typename F>
+  void forEachContaining(glm::vec2 point, F &&function) const;
+
+  // Difference between two points along the shortest way around the world
+  [[nodiscard]] static glm::vec2 wrappedDelta(glm::vec2 a, glm::vec2 b);
+
+ private:
+  struct Disk {
+    std::size_t item{};
+    glm::vec2 center{};
+    float squaredRadius{};
+  };
+
+  int m_maxResolution{};
+  int m_resolution{1};
+  float m_maxRadius{};
+
+  // Disks in insertion order
+  std::vector<Disk> m_entries;
+  // Disks sorted by cell, so that the disks of a cell are contiguous. The
+  // disks of cell c are in [m_cellStarts[c], m_cellStarts[c + 1])
+  std::vector<Disk> m_disks;
+  std::vector<std::size_t> m_cellStarts;
+  std::vector<std::size_t> m_cellCursors;
+
+  [[nodiscard]] int cellOf(glm::vec2 point) const;
+  [[nodiscard]] int cellCoordinate(float coordinate) const;
+  [[nodiscard]] int wrapCellCoordinate(int coordinate) const;
+};
+
+template <typename F>
+void SpatialHash::forEachContaining(glm::vec2 point, F &&function) const {
+  // With fewer than 3 cells per row, the neighbours wrap onto each other
+  const auto first{m_resolution >= 3 ? -1 : 0};
+  const auto count{std::min(m_resolution, 3)};
+  const auto x{cellCoordinate(point.x)};
+  const auto y{cellCoordinate(point.y)};
+
+  for (auto row{0}; row < count; ++row) {
+    const auto cellY{wrapCellCoordinate(y + first + row)};
+    for (auto column{0}; column < count; ++column) {
+      const auto cell{cellY * m_resolution +
+                      wrapCellCoordinate(x + first + column)};
+      const auto end{m_cellStarts[cell + 1]};
+      for (auto index{m_cellStarts[cell]}; index < end; ++index) {
+        const auto &disk{m_disks[index]};
+        const auto delta{wrappedDelta(point, disk.center)};
+        if (glm::dot(delta, delta) < disk.squaredRadius) function(disk.item);
+      }
+    }
+  }
+}
+
+#endif
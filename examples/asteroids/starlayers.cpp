@@ -21,6 +21,7 @@ void StarLayers::initializeGL(GLuint program, int quantity) {
     layer.m_pointSize = 10.0f / (1.0f + index);
     layer.m_quantity = quantity * (static_cast<int>(index) + 1);
     layer.m_translation = glm::vec2(0);
+    layer.m_previousTranslation = glm::vec2(0);
 
     std::vector<glm::vec3> data(0);
     for ([[maybe_unused]] auto i : iter::range(0, layer.m_quantity)) {
@@ -60,7 +61,7 @@ void StarLayers::initializeGL(GLuint program, int quantity) {
   }
 }
 
-void StarLayers::paintGL() {
+void StarLayers::paintGL(float alpha) {
   glUseProgram(m_program);
 
   glEnable(GL_BLEND);
@@ -70,14 +71,13 @@ void StarLayers::paintGL() {
     glBindVertexArray(layer.m_vao);
     glUniform1f(m_pointSizeLoc, layer.m_pointSize);
 
-    for (auto i : {-2, 0, 2}) {
-      for (auto j : {-2, 0, 2}) {
-        glUniform2f(m_translationLoc, layer.m_translation.x + j,
-                    layer.m_translation.y + i);
+    // Interpolate between the last two simulation steps
+    const auto translation{
+        glm::mix(layer.m_previousTranslation, layer.m_translation, alpha)};
+    glUniform2fv(m_translationLoc, 1, &translation.x);
 
-        glDrawArrays(GL_POINTS, 0, layer.m_quantity);
-      }
-    }
+    // One instance per wrap-around copy (see objects.vert)
+    glDrawArraysInstanced(GL_POINTS, 0, layer.m_quantity, 9);
 
     glBindVertexArray(0);
   }
@@ -97,12 +97,17 @@ void StarLayers::terminateGL() {
 void StarLayers::update(const Ship &ship, float deltaTime) {
   for (auto &&[index, layer] : iter::enumerate(m_starLayers)) {
     auto layerSpeedScale{1.0f / (index + 2.0f)};
+    layer.m_previousTranslation = layer.m_translation;
     layer.m_translation -= ship.m_velocity * deltaTime * layerSpeedScale;
 
-    // Wrap-around
-    if (layer.m_translation.x < -1.0f) layer.m_translation.x += 2.0f;
-    if (layer.m_translation.x > +1.0f) layer.m_translation.x -= 2.0f;
-    if (layer.m_translation.y < -1.0f) layer.m_translation.y += 2.0f;
-    if (layer.m_translation.y > +1.0f) layer.m_translation.y -= 2.0f;
+    // Wrap-around. The previous translation is wrapped along, so that the
+    // interpolation does not cross the screen
+    glm::vec2 wrap{0};
+    if (layer.m_translation.x < -1.0f) wrap.x += 2.0f;
+    if (layer.m_translation.x > +1.0f) wrap.x -= 2.0f;
+    if (layer.m_translation.y < -1.0f) wrap.y += 2.0f;
+    if (layer.m_translation.y > +1.0f) wrap.y -= 2.0f;
+    layer.m_translation += wrap;
+    layer.m_previousTranslation += wrap;
   }
 }
\ No newline at end of file
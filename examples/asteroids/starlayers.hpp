@@ -13,7 +13,7 @@ class OpenGLWindow;
 class StarLayers {
  public:
   void initializeGL(GLuint program, int quantity);
-  void paintGL();
+  void paintGL(float alpha);
   void terminateGL();
 
   void update(const Ship &ship, float deltaTime);
@@ -31,6 +31,7 @@ class StarLayers {
 
     float m_pointSize{};
     int m_quantity{};
+    glm::vec2 m_previousTranslation{glm::vec2(0)};
     glm::vec2 m_translation{glm::vec2(0)};
   };
 
@@ -3,8 +3,10 @@
 #include <fmt/core.h>
 #include <imgui.h>
 
+#include <cstddef>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <span>
 
 #include "abcg.hpp"
 
@@ -35,9 +37,7 @@ void OpenGLWindow::initializeGL() {
   // Create shader program
   m_program = createProgramFromString(vertexShader, fragmentShader);
 
-  // Clear window
   glClearColor(0, 0, 0, 1);
-  glClear(GL_COLOR_BUFFER_BIT);
 
   // Start pseudo-random number generator
   auto seed{std::chrono::steady_clock::now().time_since_epoch().count()};
@@ -46,27 +46,38 @@ void OpenGLWindow::initializeGL() {
   // glEnable(GL_BLEND);
   // glBlendEquation(GL_FUNC_ADD);
   // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  // Create the buffer that receives the triangle of each frame
+  m_streamBuffer.create(sizeof(m_vertices));
+  setupModel();
 }
 
 void OpenGLWindow::paintGL() {
-  // Create OpenGL buffers for the single point at m_P
-  setupModel();
+  // Create a new triangle if the delay has elapsed, and append the current
+  // one to the stream buffer
+  updateTriangle();
+  m_streamBuffer.beginFrame();
+  auto first{m_streamBuffer.pushVertices(std::span{m_vertices})};
 
-  // Set the viewport
-  glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+  // Draw on top of the previous frames
+  m_accumulation.bind();
 
   // Start using VAO
   glUseProgram(m_program);
-  // Start using buffers created in createBuffers()
+  // Start using the VAO created in setupModel()
   glBindVertexArray(m_vao);
 
-  // Draw a single point
-  glDrawArrays(GL_TRIANGLES, 0, 3);
+  // Draw a single triangle
+  glDrawArrays(GL_TRIANGLES, first, 3);
 
   // End using VAO
   glBindVertexArray(0);
   // End using the shader program
   glUseProgram(0);
+  m_streamBuffer.endFrame();
+
+  // Show everything drawn so far
+  m_accumulation.present();
 }
 
 void OpenGLWindow::paintUI() {
@@ -100,84 +111,58 @@ void OpenGLWindow::resizeGL(int width, int height) {
   m_viewportWidth = width;
   m_viewportHeight = height;
 
-  glClear(GL_COLOR_BUFFER_BIT);
+  // Keep what was drawn so far, scaled to the new size
+  m_accumulation.resize(width, height);
 }
 
 void OpenGLWindow::terminateGL() {
   // Release shader program, VBO and VAO
   glDeleteProgram(m_program);
-  glDeleteBuffers(1, &m_vboPositions);
-  glDeleteBuffers(1, &m_vboColors);
+  m_streamBuffer.destroy();
+  m_accumulation.destroy();
   glDeleteVertexArrays(1, &m_vao);
 }
 
 void OpenGLWindow::setupModel() {
-  if (m_delay_counter < m_delay) {
-    m_delay_counter+=30;
-    // fmt::print("{}\n", m_delay_counter);
-
-    return;
-  }
-  m_delay_counter = 0;
-  // SDL_Delay(m_delay);
-
-  // Release previous VBO and VAO
-  glDeleteBuffers(1, &m_vboPositions);
-  glDeleteBuffers(1, &m_vboColors);
-  glDeleteVertexArrays(1, &m_vao);
-
-  // Create vertex positions
-  std::uniform_real_distribution<float> rd(-1.5f, 1.5f);
-  std::array<glm::vec2, 3> positions{
-      glm::vec2(rd(m_randomEngine), rd(m_randomEngine)),
-      glm::vec2(rd(m_randomEngine), rd(m_randomEngine)),
-      glm::vec2(rd(m_randomEngine), rd(m_randomEngine))};
-  // Create vertex colors
-  std::vector<glm::vec4> colors(0);
-  colors.push_back(m_vertexColors[0]);
-    colors.push_back(m_vertexColors[1]);
-    colors.push_back(m_vertexColors[2]);
-
-  // Generate a new VBO and get the associated ID
-  glGenBuffers(1, &m_vboPositions);
-  // Bind VBO in order to use it
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboPositions);
-  // Upload data to VBO
-  glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions.data(),
-               GL_STATIC_DRAW);
-  // Unbinding the VBO is allowed (data can be released now)
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  // Generate VBO of colors
-  glGenBuffers(1, &m_vboColors);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboColors);
-  glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec4),
-               colors.data(), GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
   // Get location of attributes in the program
   GLint positionAttribute = glGetAttribLocation(m_program, "inPosition");
   GLint colorAttribute{glGetAttribLocation(m_program, "inColor")};
 
-  // static int delay = 1000;
-  // SDL_Delay(delay);
-
   // Create VAO
   glGenVertexArrays(1, &m_vao);
 
-  // Bind vertex attributes to current VAO
+  // Bind vertex attributes to current VAO. The vertices are read from the
+  // stream buffer at the index returned by pushVertices
   glBindVertexArray(m_vao);
 
+  glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer.getId());
   glEnableVertexAttribArray(positionAttribute);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboPositions);
-  glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
+  glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(Vertex), nullptr);
   glEnableVertexAttribArray(colorAttribute);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboColors);
-  glVertexAttribPointer(colorAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+  glVertexAttribPointer(colorAttribute, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        reinterpret_cast<void *>(offsetof(Vertex, color)));
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // End of binding to current VAO
   glBindVertexArray(0);
+}
+
+void OpenGLWindow::updateTriangle() {
+  if (m_delay_counter < m_delay) {
+    m_delay_counter+=30;
+    // fmt::print("{}\n", m_delay_counter);
+
+    return;
+  }
+  m_delay_counter = 0;
+  // SDL_Delay(m_delay);
+
+  // Create vertex positions and colors
+  std::uniform_real_distribution<float> rd(-1.5f, 1.5f);
+  for (auto index : {0, 1, 2}) {
+    m_vertices.at(index) = {
+        .position = glm::vec2(rd(m_randomEngine), rd(m_randomEngine)),
+        .color = m_vertexColors.at(index)};
+  }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define OPENGLWINDOW_HPP_
 
 #include <array>
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <random>
 
@@ -17,8 +18,9 @@ class OpenGLWindow : public abcg::OpenGLWindow {
 
  private:
   GLuint m_vao{};
-  GLuint m_vboPositions{};
-  GLuint m_vboColors{};
+  abcg::StreamBuffer m_streamBuffer;
+  // Never cleared between frames, so the drawing builds up over time
+  abcg::AccumulationTarget m_accumulation;
   GLuint m_program{};
 
   int m_viewportWidth{};
@@ -33,6 +35,13 @@ class OpenGLWindow : public abcg::OpenGLWindow {
                                           glm::vec4{0.63f, 0.00f, 0.61f, 1.0f},
                                           glm::vec4{1.00f, 0.69f, 0.30f, 1.0f}};
 
+  struct Vertex {
+    glm::vec2 position;
+    glm::vec4 color;
+  };
+  std::array<Vertex, 3> m_vertices{};
+
   void setupModel();
+  void updateTriangle();
 };
 #endif
\ No newline at end of file
@@ -73,15 +73,10 @@ void Dots::paintGL() {
   for (auto &layer : m_starLayers) {
     glBindVertexArray(layer.m_vao);
     glUniform1f(m_pointSizeLoc, layer.m_pointSize);
+    glUniform2fv(m_translationLoc, 1, &layer.m_translation.x);
 
-    for (auto i : {-2, 0, 2}) {
-      for (auto j : {-2, 0, 2}) {
-        glUniform2f(m_translationLoc, layer.m_translation.x + j,
-                    layer.m_translation.y + i);
-
-        glDrawArrays(GL_POINTS, 0, layer.m_quantity);
-      }
-    }
+    // One instance per wrap-around copy (see object.vert)
+    glDrawArraysInstanced(GL_POINTS, 0, layer.m_quantity, 9);
 
     glBindVertexArray(0);
   }
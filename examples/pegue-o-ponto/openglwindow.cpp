@@ -14,6 +14,7 @@ void OpenGLWindow::handleEvent(SDL_Event &event) {
       m_gameData.m_score = 0;
       m_dots.initializeGL(m_program, 10);
       m_player.initializeGL(m_program, 1);
+      m_timestep.reset();
     }
     if (event.key.keysym.sym == SDLK_UP || event.key.keysym.sym == SDLK_w)
       m_gameData.m_input.set(static_cast<size_t>(Input::Up));
@@ -70,8 +71,6 @@ void OpenGLWindow::restart() {
 }
 
 void OpenGLWindow::update() {
-  float deltaTime{static_cast<float>(getDeltaTime())};
-
   // Wait 5 seconds before restarting
   if ((m_gameData.m_state == State::GameOver ||
        m_gameData.m_state == State::Win) &&
@@ -80,10 +79,13 @@ void OpenGLWindow::update() {
     return;
   }
 
-  if (m_gameData.m_state == State::Playing) {
-    m_player.update(m_gameData, deltaTime);
-    checkCollisions();
-  }
+  m_alpha = static_cast<float>(
+      m_timestep.advance(getDeltaTime(), [this](double deltaTime) {
+        if (m_gameData.m_state == State::Playing) {
+          m_player.update(m_gameData, static_cast<float>(deltaTime));
+          checkCollisions();
+        }
+      }));
 }
 
 void OpenGLWindow::paintGL() {
@@ -93,7 +95,7 @@ void OpenGLWindow::paintGL() {
   glViewport(0, 0, m_viewportWidth, m_viewportHeight);
 
   m_dots.paintGL();
-  m_player.paintGL();
+  m_player.paintGL(m_alpha);
 }
 
 void OpenGLWindow::paintUI() {
@@ -31,6 +31,11 @@ class OpenGLWindow : public abcg::OpenGLWindow {
 
   abcg::ElapsedTimer m_restartWaitTimer;
 
+  // Simulation runs at 120 steps per second regardless of the frame rate
+  abcg::FixedTimestep m_timestep{120.0};
+  // Interpolation factor between the last two steps
+  float m_alpha{};
+
   ImFont* m_font{};
   ImFont* m_fontSmall{};
 
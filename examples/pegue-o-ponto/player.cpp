@@ -24,6 +24,7 @@ void PlayerLayer::initializeGL(GLuint program, int quantity) {
   float d1 = 0; //distPos(re);
   float d2 = 0; //distPos(re);
   m_player.m_translation = glm::vec2{d1, d2};
+  m_player.m_previousTranslation = m_player.m_translation;
 
   std::vector<glm::vec3> data(0);
 
@@ -68,7 +69,7 @@ void PlayerLayer::initializeGL(GLuint program, int quantity) {
   // }
 }
 
-void PlayerLayer::paintGL() {
+void PlayerLayer::paintGL(float alpha) {
   glUseProgram(m_program);
 
   glEnable(GL_BLEND);
@@ -78,14 +79,13 @@ void PlayerLayer::paintGL() {
   glBindVertexArray(m_player.m_vao);
   glUniform1f(m_pointSizeLoc, m_player.m_pointSize);
 
-  for (auto i : {-2, 0, 2}) {
-    for (auto j : {-2, 0, 2}) {
-      glUniform2f(m_translationLoc, m_player.m_translation.x + j,
-                  m_player.m_translation.y + i);
+  // Interpolate between the last two simulation steps
+  const auto translation{glm::mix(m_player.m_previousTranslation,
+                                  m_player.m_translation, alpha)};
+  glUniform2fv(m_translationLoc, 1, &translation.x);
 
-      glDrawArrays(GL_POINTS, 0, m_player.m_quantity);
-    }
-  }
+  // One instance per wrap-around copy (see object.vert)
+  glDrawArraysInstanced(GL_POINTS, 0, m_player.m_quantity, 9);
 
   glBindVertexArray(0);
   // }
@@ -116,13 +116,18 @@ void PlayerLayer::update(const GameData &gameData, float deltaTime) {
   if (gameData.m_input[static_cast<size_t>(Input::Down)])
     direction = glm::vec2{0.0f, -1.0f};
   auto layerSpeedScale{1.0f / (0 + 2.0f)};
+  m_player.m_previousTranslation = m_player.m_translation;
   m_player.m_translation += direction * deltaTime * layerSpeedScale;
 
   // fmt::print(m_player.m_translation);
-  // Wrap-around
-  if (m_player.m_translation.x < -1.0f) m_player.m_translation.x += 2.0f;
-  if (m_player.m_translation.x > +1.0f) m_player.m_translation.x -= 2.0f;
-  if (m_player.m_translation.y < -1.0f) m_player.m_translation.y += 2.0f;
-  if (m_player.m_translation.y > +1.0f) m_player.m_translation.y -= 2.0f;
+  // Wrap-around. The previous translation is wrapped along, so that the
+  // interpolation does not cross the screen
+  glm::vec2 wrap{0};
+  if (m_player.m_translation.x < -1.0f) wrap.x += 2.0f;
+  if (m_player.m_translation.x > +1.0f) wrap.x -= 2.0f;
+  if (m_player.m_translation.y < -1.0f) wrap.y += 2.0f;
+  if (m_player.m_translation.y > +1.0f) wrap.y -= 2.0f;
+  m_player.m_translation += wrap;
+  m_player.m_previousTranslation += wrap;
   // }
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ class OpenGLWindow;
 class PlayerLayer {
  public:
   void initializeGL(GLuint program, int quantity);
-  void paintGL();
+  void paintGL(float alpha);
   void terminateGL();
 
   void update(const GameData &gameData, float deltaTime);
@@ -30,6 +30,7 @@ class PlayerLayer {
 
     float m_pointSize{};
     int m_quantity{};
+    glm::vec2 m_previousTranslation{glm::vec2(0)};
     glm::vec2 m_translation{glm::vec2(0)};
   };
 
@@ -10,8 +10,8 @@ int main(int argc, char **argv) {
 
     // Create OpenGL window
     auto window{std::make_unique<OpenGLWindow>()};
-    window->setOpenGLSettings(
-        {.samples = 2, .preserveWebGLDrawingBuffer = true});
+    // Blitting the accumulation target requires a single-sampled window
+    window->setOpenGLSettings({.samples = 0});
     window->setWindowSettings({.width = 600,
                                .height = 600,
                                .showFullscreenButton = false,
@@ -3,6 +3,8 @@
 #include <imgui.h>
 
 #include <cppitertools/itertools.hpp>
+#include <cstddef>
+#include <span>
 
 #include "abcg.hpp"
 
@@ -37,9 +39,7 @@ void OpenGLWindow::initializeGL() {
   // Create shader program
   m_program = createProgramFromString(vertexShader, fragmentShader);
 
-  // Clear window
   glClearColor(0, 0, 0, 1);
-  glClear(GL_COLOR_BUFFER_BIT);
 
   // Start pseudo-random number generator
   auto seed{std::chrono::steady_clock::now().time_since_epoch().count()};
@@ -48,20 +48,36 @@ void OpenGLWindow::initializeGL() {
   // glEnable(GL_BLEND);
   // glBlendEquation(GL_FUNC_ADD);
   // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  // Create the buffer that receives the polygon of each frame, with room for
+  // the center, up to 20 sides and the duplicated vertex
+  m_streamBuffer.create(32 * sizeof(Vertex));
+  setupModel();
 }
 
 void OpenGLWindow::paintGL() {
   // Check whether to render the next polygon
-  if (m_elapsedTimer.elapsed() < m_delay / 1000.0) return;
-  m_elapsedTimer.restart();
+  if (m_elapsedTimer.elapsed() >= m_delay / 1000.0) {
+    m_elapsedTimer.restart();
+    paintPolygon();
+  }
+
+  // Show everything drawn so far, also in frames that draw nothing new
+  m_accumulation.present();
+}
 
+void OpenGLWindow::paintPolygon() {
   // Create a regular polygon with a number of sides in the range [3;20]
   std::uniform_int_distribution<int> intDist(3, 20);
   auto sides{intDist(m_randomEngine)};
-  setupModel(sides);
+  createPolygon(sides);
+
+  // Append the polygon to the stream buffer
+  m_streamBuffer.beginFrame();
+  auto first{m_streamBuffer.pushVertices(std::span{m_vertices})};
 
-  // Set the viewport
-  glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+  // Draw on top of the previous polygons
+  m_accumulation.bind();
 
   // Start using VAO
   glUseProgram(m_program);
@@ -80,11 +96,13 @@ void OpenGLWindow::paintGL() {
 
   // Render
   glBindVertexArray(m_vao);
-  glDrawArrays(GL_TRIANGLE_FAN, 0, sides + 2);
+  glDrawArrays(GL_TRIANGLE_FAN, first,
+               static_cast<GLsizei>(m_vertices.size()));
   glBindVertexArray(0);
 
   // End using the shader program
   glUseProgram(0);
+  m_streamBuffer.endFrame();
 }
 
 void OpenGLWindow::paintUI() {
@@ -103,7 +121,7 @@ void OpenGLWindow::paintUI() {
     ImGui::PopItemWidth();
 
     if (ImGui::Button("Clear window", ImVec2(-1, 30))) {
-      glClear(GL_COLOR_BUFFER_BIT);
+      m_accumulation.clear();
     }
 
     ImGui::End();
@@ -114,25 +132,44 @@ void OpenGLWindow::resizeGL(int width, int height) {
   m_viewportWidth = width;
   m_viewportHeight = height;
 
-  glClear(GL_COLOR_BUFFER_BIT);
+  // Keep what was drawn so far, scaled to the new size
+  m_accumulation.resize(width, height);
 }
 
 void OpenGLWindow::terminateGL() {
   // Release shader program, VBO and VAO
   glDeleteProgram(m_program);
-  glDeleteBuffers(1, &m_vboPositions);
-  glDeleteBuffers(1, &m_vboColors);
+  m_streamBuffer.destroy();
+  m_accumulation.destroy();
   glDeleteVertexArrays(1, &m_vao);
 }
 
-void OpenGLWindow::setupModel(int sides) {
+void OpenGLWindow::setupModel() {
+  // Get location of attributes in the program
+  GLint positionAttribute = glGetAttribLocation(m_program, "inPosition");
+  GLint colorAttribute{glGetAttribLocation(m_program, "inColor")};
 
-  // Release previous VBO and VAO
-  glDeleteBuffers(1, &m_vboPositions);
-  glDeleteBuffers(1, &m_vboColors);
-  glDeleteVertexArrays(1, &m_vao);
+  // Create VAO
+  glGenVertexArrays(1, &m_vao);
 
-  
+  // Bind vertex attributes to current VAO. The vertices are read from the
+  // stream buffer at the index returned by pushVertices
+  glBindVertexArray(m_vao);
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer.getId());
+  glEnableVertexAttribArray(positionAttribute);
+  glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE,
+                        sizeof(Vertex), nullptr);
+  glEnableVertexAttribArray(colorAttribute);
+  glVertexAttribPointer(colorAttribute, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+                        reinterpret_cast<void *>(offsetof(Vertex, color)));
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // End of binding to current VAO
+  glBindVertexArray(0);
+}
+
+void OpenGLWindow::createPolygon(int sides) {
   // Select random colors for the radial gradient
   std::uniform_real_distribution<float> rd(0.0f, 1.0f);
   glm::vec3 color1{rd(m_randomEngine), rd(m_randomEngine), rd(m_randomEngine)};
@@ -141,62 +178,20 @@ void OpenGLWindow::setupModel(int sides) {
   // Minimum number of sides is 3
   sides = std::max(3, sides);
 
-  std::vector<glm::vec2> positions(0);
-  std::vector<glm::vec3> colors(0);
+  // Reuse the capacity of the previous polygon
+  m_vertices.clear();
 
   // Polygon center
-  positions.emplace_back(0, 0);
-  colors.push_back(color1);
+  m_vertices.push_back({.position = glm::vec2(0, 0), .color = color1});
 
   // Border vertices
   auto step{M_PI * 2 / sides};
   for (auto angle : iter::range(0.0, M_PI * 2, step)) {
-    positions.emplace_back(std::cos(angle), std::sin(angle));
-    colors.push_back(color2);
+    m_vertices.push_back(
+        {.position = glm::vec2(std::cos(angle), std::sin(angle)),
+         .color = color2});
   }
 
   // Duplicate second vertex
-  positions.push_back(positions.at(1));
-  colors.push_back(color2);
-
-  // Generate a new VBO and get the associated ID
-  glGenBuffers(1, &m_vboPositions);
-  // Bind VBO in order to use it
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboPositions);
-  // Upload data to VBO
-  glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
-               positions.data(), GL_STATIC_DRAW);
-  // Unbinding the VBO is allowed (data can be released now)
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  // Generate VBO of colors
-  glGenBuffers(1, &m_vboColors);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboColors);
-  glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec3),
-               colors.data(), GL_STATIC_DRAW);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  // Get location of attributes in the program
-  GLint positionAttribute = glGetAttribLocation(m_program, "inPosition");
-  GLint colorAttribute{glGetAttribLocation(m_program, "inColor")};
-
-
-  // Create VAO
-  glGenVertexArrays(1, &m_vao);
-
-  // Bind vertex attributes to current VAO
-  glBindVertexArray(m_vao);
-
-  glEnableVertexAttribArray(positionAttribute);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboPositions);
-  glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  glEnableVertexAttribArray(colorAttribute);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboColors);
-  glVertexAttribPointer(colorAttribute, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-  // End of binding to current VAO
-  glBindVertexArray(0);
-}
\ No newline at end of file
+  m_vertices.push_back(m_vertices.at(1));
+}
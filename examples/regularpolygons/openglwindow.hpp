@@ -1,7 +1,10 @@
 #ifndef OPENGLWINDOW_HPP_
 #define OPENGLWINDOW_HPP_
 
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 #include <random>
+#include <vector>
 
 #include "abcg.hpp"
 
@@ -15,8 +18,9 @@ class OpenGLWindow : public abcg::OpenGLWindow {
 
  private:
   GLuint m_vao{};
-  GLuint m_vboPositions{};
-  GLuint m_vboColors{};
+  abcg::StreamBuffer m_streamBuffer;
+  // Never cleared between frames, so the drawing builds up over time
+  abcg::AccumulationTarget m_accumulation;
   GLuint m_program{};
 
   int m_viewportWidth{};
@@ -27,6 +31,14 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   int m_delay{200};
    abcg::ElapsedTimer m_elapsedTimer;
 
-  void setupModel(int sides);
+  struct Vertex {
+    glm::vec2 position;
+    glm::vec3 color;
+  };
+  std::vector<Vertex> m_vertices;
+
+  void setupModel();
+  void createPolygon(int sides);
+  void paintPolygon();
 };
 #endif
\ No newline at end of file
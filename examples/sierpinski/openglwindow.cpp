@@ -3,17 +3,29 @@
 #include <fmt/core.h>
 #include <imgui.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cppitertools/itertools.hpp>
+#include <span>
 
 #include "abcg.hpp"
 
+namespace {
+// Largest number of points per frame of the batched modes
+constexpr int maxBatchSizeLog2{20};
+constexpr std::size_t maxBatchSize{std::size_t{1} << maxBatchSizeLog2};
+
+// Fewer points per thread are not worth starting a thread for
+constexpr std::size_t minPointsPerThread{16384};
+}  // namespace
+
 void OpenGLWindow::initializeGL() {
   const auto *vertexShader{R"gl(
     #version 410
     layout(location = 0) in vec2 inPosition;
-    void main() { 
+    void main() {
       gl_PointSize = 1.0;
-      gl_Position = vec4(inPosition, 0, 1); 
+      gl_Position = vec4(inPosition, 0, 1);
     }
   )gl"};
 
@@ -23,12 +35,44 @@ void OpenGLWindow::initializeGL() {
     void main() { outColor = vec4(1); }
   )gl"};
 
-  // Create shader program
+  // Draws the points of one step of the chains and outputs the next step,
+  // choosing the triangle vertex by hashing the point index with a seed
+  // that changes every frame
+  const auto *feedbackVertexShader{R"gl(
+    #version 410
+    layout(location = 0) in vec2 inPosition;
+
+    uniform uint seed;
+
+    out vec2 outPosition;
+
+    const vec2 vertices[3] = vec2[3](vec2(0, 1), vec2(-1, -1), vec2(1, -1));
+
+    uint hash(uint x) {
+      x ^= x >> 16u;
+      x *= 0x7feb352du;
+      x ^= x >> 15u;
+      x *= 0x846ca68bu;
+      x ^= x >> 16u;
+      return x;
+    }
+
+    void main() {
+      uint index = hash(uint(gl_VertexID) ^ hash(seed)) % 3u;
+      outPosition = (inPosition + vertices[index]) / 2.0;
+      gl_PointSize = 1.0;
+      gl_Position = vec4(inPosition, 0, 1);
+    }
+  )gl"};
+
+  // Create shader programs
   m_program = createProgramFromString(vertexShader, fragmentShader);
+  const std::array<const char *, 1> varyings{"outPosition"};
+  m_feedbackProgram = createProgramFromString(feedbackVertexShader,
+                                              fragmentShader, varyings);
+  m_seedLoc = glGetUniformLocation(m_feedbackProgram, "seed");
 
-  // Clear window
   glClearColor(0, 0, 0, 1);
-  glClear(GL_COLOR_BUFFER_BIT);
 
 #if !defined(__EMSCRIPTEN__)
   glEnable(GL_PROGRAM_POINT_SIZE);
@@ -45,28 +89,52 @@ void OpenGLWindow::initializeGL() {
   std::uniform_real_distribution<float> realDistribution(-1.0f, 1.0f);
   m_P.x = realDistribution(m_randomEngine);
   m_P.y = realDistribution(m_randomEngine);
+
+  // Create the buffer that receives the points of each frame
+  m_streamBuffer.create(maxBatchSize * sizeof(glm::vec2));
+  setupModel();
+  createChains();
 }
 
 void OpenGLWindow::paintGL() {
-  // Create OpenGL buffers for the single point at m_P
-  setupModel();
+  // Draw on top of the previous frames
+  m_accumulation.bind();
+
+  switch (m_mode) {
+    case Mode::Single:
+      paintSingle();
+      break;
+    case Mode::Batched:
+      paintBatched();
+      break;
+    case Mode::TransformFeedback:
+      paintTransformFeedback();
+      break;
+  }
+
+  // Show everything drawn so far
+  m_accumulation.present();
+}
 
-  // Set the viewport
-  glViewport(0, 0, m_viewportWidth, m_viewportHeight);
+void OpenGLWindow::paintSingle() {
+  // Append the single point at m_P to the stream buffer
+  m_streamBuffer.beginFrame();
+  auto first{m_streamBuffer.pushVertices(std::span{&m_P, 1})};
 
   // Start using VAO
   glUseProgram(m_program);
-  // Start using buffers created in createBuffers()
+  // Start using the VAO created in setupModel()
   glBindVertexArray(m_vao);
 
   // Draw a single point
-  glDrawArrays(GL_POINTS, 0, 1);
+  glDrawArrays(GL_POINTS, first, 1);
 
   // End using VAO
   glBindVertexArray(0);
   // End using the shader program
   glUseProgram(0);
-  
+  m_streamBuffer.endFrame();
+
   // Randomly choose a triangle vertex index
   std::uniform_int_distribution<int> intDistribution(0, m_points.size() - 1);
   int index{intDistribution(m_randomEngine)};
@@ -79,6 +147,48 @@ void OpenGLWindow::paintGL() {
   // fmt::print("({:+.2f}, {:+.2f})\n", m_P.x, m_P.y);
 }
 
+void OpenGLWindow::paintBatched() {
+  generateBatch();
+
+  // Append the whole batch to the stream buffer
+  m_streamBuffer.beginFrame();
+  auto first{m_streamBuffer.pushVertices(std::span{m_batch})};
+
+  glUseProgram(m_program);
+  glBindVertexArray(m_vao);
+
+  // Draw all points of the frame with a single call
+  glDrawArrays(GL_POINTS, first, static_cast<GLsizei>(m_batch.size()));
+
+  glBindVertexArray(0);
+  glUseProgram(0);
+  m_streamBuffer.endFrame();
+}
+
+void OpenGLWindow::paintTransformFeedback() {
+  // Recreate the chains if the number of points changed
+  if (m_feedbackPoints != std::size_t{1} << m_batchSizeLog2) setupFeedback();
+
+  const auto target{1 - m_feedbackSource};
+
+  glUseProgram(m_feedbackProgram);
+  glUniform1ui(m_seedLoc, m_frameSeed++);
+
+  // Draw the current points and capture the next ones
+  glBindVertexArray(m_feedbackVAOs.at(m_feedbackSource));
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0,
+                   m_feedbackVBOs.at(target));
+  glBeginTransformFeedback(GL_POINTS);
+  glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(m_feedbackPoints));
+  glEndTransformFeedback();
+  glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+
+  glBindVertexArray(0);
+  glUseProgram(0);
+
+  m_feedbackSource = target;
+}
+
 void OpenGLWindow::paintUI() {
   abcg::OpenGLWindow::paintUI();
 
@@ -87,7 +197,37 @@ void OpenGLWindow::paintUI() {
     ImGui::Begin(" ", nullptr, ImGuiWindowFlags_NoDecoration);
 
     if (ImGui::Button("Clear window", ImVec2(150, 30))) {
-      glClear(GL_COLOR_BUFFER_BIT);
+      m_accumulation.clear();
+    }
+
+    // Mode combo box
+    {
+      std::array comboItems{"Single point", "Batched (CPU)",
+                            "Transform feedback"};
+      auto currentIndex{static_cast<std::size_t>(m_mode)};
+
+      ImGui::PushItemWidth(150);
+      if (ImGui::BeginCombo("Mode", comboItems.at(currentIndex))) {
+        for (auto index : iter::range(comboItems.size())) {
+          const bool isSelected{currentIndex == index};
+          if (ImGui::Selectable(comboItems.at(index), isSelected))
+            m_mode = static_cast<Mode>(index);
+          if (isSelected) ImGui::SetItemDefaultFocus();
+        }
+        ImGui::EndCombo();
+      }
+      ImGui::PopItemWidth();
+    }
+
+    if (m_mode != Mode::Single) {
+      ImGui::PushItemWidth(150);
+      ImGui::SliderInt("Points", &m_batchSizeLog2, 0, maxBatchSizeLog2,
+                       "2^%d per frame");
+      ImGui::PopItemWidth();
+
+      const auto pointsPerFrame{static_cast<double>(1 << m_batchSizeLog2)};
+      ImGui::Text("%.1f M points/s",
+                  pointsPerFrame / std::max(getDeltaTime(), 1e-6) / 1e6);
     }
 
     ImGui::End();
@@ -98,44 +238,173 @@ void OpenGLWindow::resizeGL(int width, int height) {
   m_viewportWidth = width;
   m_viewportHeight = height;
 
-  glClear(GL_COLOR_BUFFER_BIT);
+  // Keep what was drawn so far, scaled to the new size
+  m_accumulation.resize(width, height);
 }
 
 void OpenGLWindow::terminateGL() {
-  // Release shader program, VBO and VAO
+  stopWorkers();
+
+  // Release shader programs, VBOs and VAOs
   glDeleteProgram(m_program);
-  glDeleteBuffers(1, &m_vboVertices);
+  glDeleteProgram(m_feedbackProgram);
+  m_streamBuffer.destroy();
+  m_accumulation.destroy();
   glDeleteVertexArrays(1, &m_vao);
+  glDeleteBuffers(2, m_feedbackVBOs.data());
+  glDeleteVertexArrays(2, m_feedbackVAOs.data());
 }
 
 void OpenGLWindow::setupModel() {
-  // Release previous VBO and VAO
-  glDeleteBuffers(1, &m_vboVertices);
-  glDeleteVertexArrays(1, &m_vao);
-
-  // Generate a new VBO and get the associated ID
-  glGenBuffers(1, &m_vboVertices);
-  // Bind VBO in order to use it
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboVertices);
-  // Upload data to VBO
-  glBufferData(GL_ARRAY_BUFFER, sizeof(m_P), &m_P, GL_STATIC_DRAW);
-  // Unbinding the VBO is allowed (data can be released now)
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
-
   // Get location of attributes in the program
   GLint positionAttribute = glGetAttribLocation(m_program, "inPosition");
 
   // Create VAO
   glGenVertexArrays(1, &m_vao);
 
-  // Bind vertex attributes to current VAO
+  // Bind vertex attributes to current VAO. The points are read from the
+  // stream buffer at the index returned by pushVertices
   glBindVertexArray(m_vao);
 
   glEnableVertexAttribArray(positionAttribute);
-  glBindBuffer(GL_ARRAY_BUFFER, m_vboVertices);
+  glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer.getId());
   glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // End of binding to current VAO
   glBindVertexArray(0);
-}
\ No newline at end of file
+}
+
+void OpenGLWindow::setupFeedback() {
+  // Release previous VBOs and VAOs
+  glDeleteBuffers(2, m_feedbackVBOs.data());
+  glDeleteVertexArrays(2, m_feedbackVAOs.data());
+
+  // Start the GPU chains from a CPU batch, whose points are already on the
+  // attractor
+  generateBatch();
+  m_feedbackPoints = m_batch.size();
+  m_feedbackSource = 0;
+
+  GLint positionAttribute{
+      glGetAttribLocation(m_feedbackProgram, "inPosition")};
+
+  glGenBuffers(2, m_feedbackVBOs.data());
+  glGenVertexArrays(2, m_feedbackVAOs.data());
+  for (auto index : {0U, 1U}) {
+    glBindBuffer(GL_ARRAY_BUFFER, m_feedbackVBOs.at(index));
+    glBufferData(GL_ARRAY_BUFFER, m_batch.size() * sizeof(glm::vec2),
+                 m_batch.data(), GL_DYNAMIC_COPY);
+
+    glBindVertexArray(m_feedbackVAOs.at(index));
+    glEnableVertexAttribArray(positionAttribute);
+    glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0,
+                          nullptr);
+    glBindVertexArray(0);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void OpenGLWindow::createChains() {
+#if defined(__EMSCRIPTEN__)
+  const auto chainCount{1U};
+#else
+  const auto chainCount{std::max(std::thread::hardware_concurrency(), 1U)};
+#endif
+
+  std::uniform_real_distribution<float> realDistribution(-1.0f, 1.0f);
+  m_chains.resize(chainCount);
+  for (auto &chain : m_chains) {
+    chain.randomEngine.seed(m_randomDevice());
+    chain.point = {realDistribution(chain.randomEngine),
+                   realDistribution(chain.randomEngine)};
+
+    // Each step halves the distance to the attractor, so after 32 steps the
+    // points are closer to it than a pixel
+    for ([[maybe_unused]] auto step : iter::range(32)) {
+      chain.point = (chain.point + m_points[chain.randomEngine() % 3]) / 2.0f;
+    }
+  }
+
+  // Starting threads costs more than generating a small batch, so they are
+  // started once and reused by every frame
+  m_workers.reserve(chainCount - 1);
+  for (std::size_t chainIndex{1}; chainIndex < chainCount; ++chainIndex) {
+    m_workers.emplace_back(&OpenGLWindow::workerLoop, this, chainIndex);
+  }
+}
+
+void OpenGLWindow::stopWorkers() {
+  {
+    const std::lock_guard lock{m_workerMutex};
+    m_stopWorkers = true;
+  }
+  m_batchStarted.notify_all();
+  for (auto &worker : m_workers) {
+    worker.join();
+  }
+  m_workers.clear();
+}
+
+void OpenGLWindow::workerLoop(std::size_t chainIndex) {
+  std::uint64_t lastBatchIndex{};
+  while (true) {
+    std::size_t chainCount{};
+    {
+      std::unique_lock lock{m_workerMutex};
+      m_batchStarted.wait(lock, [this, lastBatchIndex] {
+        return m_stopWorkers || m_batchIndex != lastBatchIndex;
+      });
+      if (m_stopWorkers) return;
+      lastBatchIndex = m_batchIndex;
+      chainCount = m_batchChains;
+    }
+
+    // Small batches do not use every chain
+    if (chainIndex >= chainCount) continue;
+
+    generateChain(chainIndex, chainCount);
+
+    {
+      const std::lock_guard lock{m_workerMutex};
+      if (--m_pendingChains == 0) m_batchFinished.notify_one();
+    }
+  }
+}
+
+void OpenGLWindow::generateBatch() {
+  const auto count{std::size_t{1} << m_batchSizeLog2};
+  m_batch.resize(count);
+
+  // Wake the workers of the chains used by this batch
+  const auto chainCount{std::clamp<std::size_t>(count / minPointsPerThread,
+                                                1, m_chains.size())};
+  {
+    const std::lock_guard lock{m_workerMutex};
+    m_batchChains = chainCount;
+    m_pendingChains = chainCount - 1;
+    ++m_batchIndex;
+  }
+  m_batchStarted.notify_all();
+
+  // The first chain runs on this thread
+  generateChain(0, chainCount);
+
+  std::unique_lock lock{m_workerMutex};
+  m_batchFinished.wait(lock, [this] { return m_pendingChains == 0; });
+}
+
+// Fills the contiguous range of the batch that belongs to a chain
+void OpenGLWindow::generateChain(std::size_t chainIndex,
+                                 std::size_t chainCount) {
+  auto &chain{m_chains[chainIndex]};
+  const auto count{m_batch.size()};
+  const auto begin{count * chainIndex / chainCount};
+  const auto end{count * (chainIndex + 1) / chainCount};
+  auto point{chain.point};
+  for (auto index{begin}; index < end; ++index) {
+    point = (point + m_points[chain.randomEngine() % 3]) / 2.0f;
+    m_batch[index] = point;
+  }
+  chain.point = point;
+}
@@ -2,8 +2,13 @@
 #define OPENGLWINDOW_HPP_
 
 #include <array>
+#include <condition_variable>
+#include <cstdint>
 #include <glm/vec2.hpp>
+#include <mutex>
 #include <random>
+#include <thread>
+#include <vector>
 
 #include "abcg.hpp"
 
@@ -16,21 +21,70 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   void terminateGL() override;
 
  private:
+  // How the points of each frame are generated
+  enum class Mode { Single, Batched, TransformFeedback };
+
   GLuint m_vao{};
-  GLuint m_vboVertices{};
+  abcg::StreamBuffer m_streamBuffer;
+  // Never cleared between frames, so the drawing builds up over time
+  abcg::AccumulationTarget m_accumulation;
   GLuint m_program{};
 
+  // Chains advanced on the GPU. Each frame draws the points of one buffer
+  // and captures the next points into the other
+  std::array<GLuint, 2> m_feedbackVAOs{};
+  std::array<GLuint, 2> m_feedbackVBOs{};
+  std::size_t m_feedbackSource{};
+  std::size_t m_feedbackPoints{};
+  GLuint m_feedbackProgram{};
+  GLint m_seedLoc{};
+  GLuint m_frameSeed{};
+
   int m_viewportWidth{};
   int m_viewportHeight{};
 
   std::random_device m_randomDevice;
   std::default_random_engine m_randomEngine;
 
-  const std::array<glm::vec2, 3> m_points{glm::vec2( 0,  1), 
+  const std::array<glm::vec2, 3> m_points{glm::vec2( 0,  1),
                                           glm::vec2(-1, -1),
                                           glm::vec2( 1, -1)};
   glm::vec2 m_P{};
 
+  Mode m_mode{Mode::Single};
+  // Base 2 logarithm of the number of points per frame of the batched modes
+  int m_batchSizeLog2{16};
+
+  // Independent chains of the batched mode, each advanced by its own thread
+  // with its own random number generator
+  struct Chain {
+    std::default_random_engine randomEngine;
+    glm::vec2 point{};
+  };
+  std::vector<Chain> m_chains;
+  std::vector<glm::vec2> m_batch;
+
+  // Persistent threads of chains 1 and up; chain 0 runs on the main thread.
+  // Each batch increments m_batchIndex to wake them.
+  std::vector<std::thread> m_workers;
+  std::mutex m_workerMutex;
+  std::condition_variable m_batchStarted;
+  std::condition_variable m_batchFinished;
+  std::uint64_t m_batchIndex{};
+  std::size_t m_batchChains{};
+  std::size_t m_pendingChains{};
+  bool m_stopWorkers{};
+
   void setupModel();
+  void setupFeedback();
+  void createChains();
+  void stopWorkers();
+  void workerLoop(std::size_t chainIndex);
+  void generateBatch();
+  void generateChain(std::size_t chainIndex, std::size_t chainCount);
+
+  void paintSingle();
+  void paintBatched();
+  void paintTransformFeedback();
 };
-#endif
\ No newline at end of file
+#endif
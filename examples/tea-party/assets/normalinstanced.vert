@@ -0,0 +1,28 @@
+#version 410
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+// Per-instance attributes
+layout(location = 3) in mat4 inModelMatrix;
+
+// Per-frame camera and light properties
+layout(std140) uniform FrameUniforms {
+  highp mat4 viewMatrix;
+  highp mat4 projMatrix;
+  highp vec4 lightDirWorldSpace;
+  highp vec4 Ia, Id, Is;
+};
+
+out vec4 fragColor;
+
+void main() {
+  mat4 MVP = projMatrix * viewMatrix * inModelMatrix;
+
+  gl_Position = MVP * vec4(inPosition, 1.0);
+
+  vec3 N = inNormal;  // Object space
+
+  // Convert from [-1,1] to [0,1]
+  fragColor = vec4((N + 1.0) / 2.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#version 410
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+
+// Per-instance attributes
+layout(location = 3) in mat4 inModelMatrix;
+layout(location = 7) in mat3 inNormalMatrix;  // World space
+layout(location = 10) in vec4 inKa;
+layout(location = 11) in vec4 inKd;
+layout(location = 12) in vec4 inKs;
+layout(location = 13) in float inShininess;
+
+// Per-frame camera and light properties
+layout(std140) uniform FrameUniforms {
+  highp mat4 viewMatrix;
+  highp mat4 projMatrix;
+  highp vec4 lightDirWorldSpace;
+  highp vec4 Ia, Id, Is;
+};
+
+out vec3 fragV;
+out vec3 fragL;
+out vec3 fragN;
+flat out vec4 fragKa;
+flat out vec4 fragKd;
+flat out vec4 fragKs;
+flat out float fragShininess;
+
+void main() {
+  vec3 P = (viewMatrix * inModelMatrix * vec4(inPosition, 1.0)).xyz;
+  // The view matrix is a rigid transform, so its rotation part is its own
+  // inverse transpose
+  vec3 N = mat3(viewMatrix) * inNormalMatrix * inNormal;
+  vec3 L = -(viewMatrix * lightDirWorldSpace).xyz;
+
+  fragL = L;
+  fragV = -P;
+  fragN = N;
+  fragKa = inKa;
+  fragKd = inKd;
+  fragKs = inKs;
+  fragShininess = inShininess;
+
+  gl_Position = projMatrix * vec4(P, 1.0);
+}
@@ -1,45 +1,41 @@
 #include "model.hpp"
 
 #include <fmt/core.h>
-#include <tiny_obj_loader.h>
 
 #include <cppitertools/itertools.hpp>
+#include <cstddef>
 #include <filesystem>
-#include <glm/gtx/hash.hpp>
-#include <unordered_map>
-
-// Custom specialization of std::hash injected in namespace std
-namespace std {
-template <>
-struct hash<Vertex> {
-  size_t operator()(Vertex const& vertex) const noexcept {
-    std::size_t h1{std::hash<glm::vec3>()(vertex.position)};
-    std::size_t h2{std::hash<glm::vec3>()(vertex.normal)};
-    std::size_t h3{std::hash<glm::vec2>()(vertex.texCoord)};
-    return h1 ^ h2 ^ h3;
-  }
-};
-}  // namespace std
+#include <glm/gtc/matrix_inverse.hpp>
 
 Model::~Model() {
   glDeleteTextures(1, &m_diffuseTexture);
+  glDeleteBuffers(1, &m_instanceVBO);
   glDeleteBuffers(1, &m_EBO);
   glDeleteBuffers(1, &m_VBO);
   glDeleteVertexArrays(1, &m_VAO);
 }
 
-void Model::computeNormals() {
+// Filtering and wrapping parameters are set by abcg::opengl::createTexture
+void Model::bindDiffuseTexture() const {
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_diffuseTexture);
+}
+
+void Model::computeNormals(MeshData& data) {
+  auto& vertices{data.vertices};
+  const auto& indices{data.indices};
+
   // Clear previous vertex normals
-  for (auto& vertex : m_vertices) {
+  for (auto& vertex : vertices) {
     vertex.normal = glm::zero<glm::vec3>();
   }
 
   // Compute face normals
-  for (const auto offset : iter::range<int>(0, m_indices.size(), 3)) {
+  for (const auto offset : iter::range<int>(0, indices.size(), 3)) {
     // Get face vertices
-    Vertex& a{m_vertices.at(m_indices.at(offset + 0))};
-    Vertex& b{m_vertices.at(m_indices.at(offset + 1))};
-    Vertex& c{m_vertices.at(m_indices.at(offset + 2))};
+    Vertex& a{vertices.at(indices.at(offset + 0))};
+    Vertex& b{vertices.at(indices.at(offset + 1))};
+    Vertex& c{vertices.at(indices.at(offset + 2))};
 
     // Compute normal
     const auto edge1{b.position - a.position};
@@ -53,11 +49,11 @@ void Model::computeNormals() {
   }
 
   // Normalize
-  for (auto& vertex : m_vertices) {
+  for (auto& vertex : vertices) {
     vertex.normal = glm::normalize(vertex.normal);
   }
 
-  m_hasNormals = true;
+  data.info.hasNormals = true;
 }
 
 void Model::createBuffers() {
@@ -78,6 +74,25 @@ void Model::createBuffers() {
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_indices[0]) * m_indices.size(),
                m_indices.data(), GL_STATIC_DRAW);
   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  // Instance VBO, filled by setInstances
+  if (m_instanceVBO == 0) glGenBuffers(1, &m_instanceVBO);
+}
+
+// Adds a draw of the whole model to a render queue, which binds the VAO and
+// the diffuse texture only when they change
+void Model::enqueue(
+    abcg::RenderQueue& queue, const abcg::ShaderProgram& program,
+    std::initializer_list<abcg::RenderQueue::Uniform> uniforms) const {
+  // Not loaded yet
+  if (m_VAO == 0) return;
+
+  abcg::RenderQueue::DrawItem item{
+      .program = &program,
+      .vao = m_VAO,
+      .count = static_cast<GLsizei>(m_indices.size())};
+  item.textures[0].id = m_diffuseTexture;
+  queue.push(item, uniforms);
 }
 
 void Model::loadDiffuseTexture(std::string_view path) {
@@ -87,142 +102,219 @@ void Model::loadDiffuseTexture(std::string_view path) {
   m_diffuseTexture = abcg::opengl::loadTexture(path);
 }
 
+void Model::loadDiffuseTextureAsync(abcg::AssetLoader& loader,
+                                    std::string_view path) {
+  if (!std::filesystem::exists(path)) return;
+
+  loader.enqueue<abcg::ImageData>(
+      [path = std::string{path}] { return abcg::loadImage(path); },
+      [this](abcg::ImageData& image) {
+        glDeleteTextures(1, &m_diffuseTexture);
+        m_diffuseTexture = abcg::opengl::createTexture(image);
+      });
+}
+
 void Model::loadFromFile(std::string_view path, GLuint program, bool standardize) {
+  auto data{loadMeshData(path, standardize)};
+  setMeshData(data, program);
+}
+
+void Model::loadFromFileAsync(abcg::AssetLoader& loader, std::string_view path,
+                              GLuint program, bool standardize) {
+  loader.enqueue<MeshData>(
+      [path = std::string{path}, standardize] {
+        // Already on a loader worker: parse on this thread only, as other
+        // workers may be importing models at the same time
+        return loadMeshData(path, standardize, 1);
+      },
+      [this, program](MeshData& data) { setMeshData(data, program); });
+}
+
+// Loads the mesh and its diffuse map into CPU memory. Does not call OpenGL,
+// so it can run on a worker thread. numThreads is the maximum number of
+// threads used to parse the OBJ file (zero for all hardware threads).
+MeshData Model::loadMeshData(std::string_view path, bool standardize,
+                             unsigned int numThreads) {
   auto basePath{std::filesystem::path{path}.parent_path().string() + "/"};
 
-  tinyobj::ObjReaderConfig readerConfig;
-  readerConfig.mtl_search_path = basePath;  // Path to material files
+  // Try the binary cache first; parse the OBJ file only on a cache miss
+  MeshData data{};
+  if (const abcg::MeshCache cache{path, standardize ? 1U : 0U};
+      !cache.read(data.vertices, data.indices, data.info)) {
+    parseObjFile(path, data, numThreads);
 
-  tinyobj::ObjReader reader;
+    if (standardize) {
+      Model::standardize(data);
+    }
 
-  if (!reader.ParseFromFile(path.data(), readerConfig)) {
-    if (!reader.Error().empty()) {
-      throw abcg::Exception{abcg::Exception::Runtime(
-          fmt::format("Failed to load model {} ({})", path, reader.Error()))};
+    if (!data.info.hasNormals) {
+      computeNormals(data);
     }
-    throw abcg::Exception{
-        abcg::Exception::Runtime(fmt::format("Failed to load model {}", path))};
+
+    cache.write(data.vertices, data.indices, data.info);
   }
 
-  if (!reader.Warning().empty()) {
-    fmt::print("Warning: {}\n", reader.Warning());
+  if (const auto& texName{data.info.diffuseTexName};
+      !texName.empty() && std::filesystem::exists(basePath + texName)) {
+    data.diffuseImage = abcg::loadImage(basePath + texName);
   }
 
-  const auto& attrib{reader.GetAttrib()};
-  const auto& shapes{reader.GetShapes()};
-  const auto& materials{reader.GetMaterials()};
-
-  m_vertices.clear();
-  m_indices.clear();
-
-  m_hasNormals = false;
-  m_hasTexCoords = false;
-
-  // A key:value map with key=Vertex and value=index
-  std::unordered_map<Vertex, GLuint> hash{};
-
-  // Loop over shapes
-  for (const auto& shape : shapes) {
-    // Loop over indices
-    for (const auto offset : iter::range(shape.mesh.indices.size())) {
-      // Access to vertex
-      tinyobj::index_t index{shape.mesh.indices.at(offset)};
-
-      // Vertex coordinates
-      std::size_t startIndex{static_cast<size_t>(3 * index.vertex_index)};
-      float vx{attrib.vertices.at(startIndex + 0)};
-      float vy{attrib.vertices.at(startIndex + 1)};
-      float vz{attrib.vertices.at(startIndex + 2)};
-
-      // Vertex normal
-      float nx{};
-      float ny{};
-      float nz{};
-      if (index.normal_index >= 0) {
-        m_hasNormals = true;
-        startIndex = 3 * index.normal_index;
-        nx = attrib.normals.at(startIndex + 0);
-        ny = attrib.normals.at(startIndex + 1);
-        nz = attrib.normals.at(startIndex + 2);
-      }
-
-      // Vertex texture coordinates
-      float tu{};
-      float tv{};
-      if (index.texcoord_index >= 0) {
-        m_hasTexCoords = true;
-        startIndex = 2 * index.texcoord_index;
-        tu = attrib.texcoords.at(startIndex + 0);
-        tv = attrib.texcoords.at(startIndex + 1);
-      }
-    
-      Vertex vertex{};
-      vertex.position = {vx, vy, vz};
-      vertex.normal = {nx, ny, nz};
-      vertex.texCoord = {tu, tv};
-
-      // If hash doesn't contain this vertex
-      if (hash.count(vertex) == 0) {
-        // Add this index (size of m_vertices)
-        hash[vertex] = m_vertices.size();
-        // Add this vertex
-        m_vertices.push_back(vertex);
-      }
-
-      m_indices.push_back(hash[vertex]);
+  return data;
+}
+
+void Model::parseObjFile(std::string_view path, MeshData& data,
+                         unsigned int numThreads) {
+  const auto mesh{abcg::importObjFile(path, numThreads)};
+  const auto& materials{mesh.materials};
+
+  data.vertices.clear();
+  data.indices.clear();
+
+  auto& info{data.info};
+  info.hasNormals = false;
+  info.hasTexCoords = false;
+
+  // Merges duplicate vertices into data.vertices
+  abcg::VertexWelder<Vertex> welder{data.vertices};
+
+  // Loop over indices
+  for (const auto& index : mesh.indices) {
+    // Vertex coordinates
+    std::size_t startIndex{static_cast<size_t>(3 * index.vertex_index)};
+    float vx{mesh.vertices.at(startIndex + 0)};
+    float vy{mesh.vertices.at(startIndex + 1)};
+    float vz{mesh.vertices.at(startIndex + 2)};
+
+    // Vertex normal
+    float nx{};
+    float ny{};
+    float nz{};
+    if (index.normal_index >= 0) {
+      info.hasNormals = true;
+      startIndex = 3 * index.normal_index;
+      nx = mesh.normals.at(startIndex + 0);
+      ny = mesh.normals.at(startIndex + 1);
+      nz = mesh.normals.at(startIndex + 2);
+    }
+
+    // Vertex texture coordinates
+    float tu{};
+    float tv{};
+    if (index.texcoord_index >= 0) {
+      info.hasTexCoords = true;
+      startIndex = 2 * index.texcoord_index;
+      tu = mesh.texcoords.at(startIndex + 0);
+      tv = mesh.texcoords.at(startIndex + 1);
     }
+
+    Vertex vertex{};
+    vertex.position = {vx, vy, vz};
+    vertex.normal = {nx, ny, nz};
+    vertex.texCoord = {tu, tv};
+
+    data.indices.push_back(welder.insert(vertex));
   }
 
+  // The cache checks these files to detect edited materials
+  info.materialLibraries = mesh.materialLibraries;
+
   // Use properties of first material, if available
   if (!materials.empty()) {
     const auto& mat{materials.at(0)};  // First material
-    m_Ka = glm::vec4(mat.ambient[0], mat.ambient[1], mat.ambient[2], 1);
-    m_Kd = glm::vec4(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2], 1);
-    m_Ks = glm::vec4(mat.specular[0], mat.specular[1], mat.specular[2], 1);
-    m_shininess = mat.shininess;
-
-    if (!mat.diffuse_texname.empty())
-      loadDiffuseTexture(basePath + mat.diffuse_texname);
+    info.Ka = glm::vec4(mat.ambient[0], mat.ambient[1], mat.ambient[2], 1);
+    info.Kd = glm::vec4(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2], 1);
+    info.Ks = glm::vec4(mat.specular[0], mat.specular[1], mat.specular[2], 1);
+    info.shininess = mat.shininess;
+    info.diffuseTexName = mat.diffuse_texname;
   } else {
     // Default values
-    m_Ka = {0.1f, 0.1f, 0.1f, 1.0f};
-    m_Kd = {0.7f, 0.7f, 0.7f, 1.0f};
-    m_Ks = {1.0f, 1.0f, 1.0f, 1.0f};
-    m_shininess = 25.0f;
+    info.Ka = {0.1f, 0.1f, 0.1f, 1.0f};
+    info.Kd = {0.7f, 0.7f, 0.7f, 1.0f};
+    info.Ks = {1.0f, 1.0f, 1.0f, 1.0f};
+    info.shininess = 25.0f;
   }
+}
 
-  if (standardize) {
-    this->standardize();
-  }
+void Model::render(int numTriangles) const {
+  // Not loaded yet
+  if (m_VAO == 0) return;
 
-  if (!m_hasNormals) {
-    computeNormals();
-  }
+  glBindVertexArray(m_VAO);
 
-  createBuffers();
+  bindDiffuseTexture();
 
-  setupVAO(program);
+  GLsizei numIndices = (numTriangles < 0) ? m_indices.size() : numTriangles * 3;
+
+  glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, nullptr);
+
+  glBindVertexArray(0);
 }
 
-void Model::render(int numTriangles) const {
+// Draws all instances with a single draw call. The VAO must have been set up
+// with a program that reads the per-instance attributes (inModelMatrix,
+// inNormalMatrix, inKa, inKd, inKs, inShininess).
+void Model::renderInstanced() const {
+  // Not loaded yet
+  if (m_VAO == 0 || m_numInstances == 0) return;
+
   glBindVertexArray(m_VAO);
 
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, m_diffuseTexture);
+  bindDiffuseTexture();
 
-  // Set minification and magnification parameters
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()),
+                          GL_UNSIGNED_INT, nullptr, m_numInstances);
 
-  // Set texture wrapping parameters
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glBindVertexArray(0);
+}
 
-  GLsizei numIndices = (numTriangles < 0) ? m_indices.size() : numTriangles * 3;
+// Uploads the per-instance attributes drawn by renderInstanced. Can be called
+// before the model is loaded; only needs to be called again when the
+// instances change.
+void Model::setInstances(std::span<const ModelInstance> instances) {
+  // The normal matrix in world space does not depend on the camera, so it is
+  // computed once per instance instead of once per vertex
+  std::vector<InstanceAttributes> attributes;
+  attributes.reserve(instances.size());
+  for (const auto& instance : instances) {
+    attributes.push_back(
+        {.modelMatrix = instance.modelMatrix,
+         .normalMatrix = glm::inverseTranspose(glm::mat3(instance.modelMatrix)),
+         .Ka = instance.Ka,
+         .Kd = instance.Kd,
+         .Ks = instance.Ks,
+         .shininess = instance.shininess});
+  }
 
-  glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, nullptr);
+  // The VAO created by setupVAO keeps referring to the same buffer object
+  if (m_instanceVBO == 0) glGenBuffers(1, &m_instanceVBO);
+  glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceAttributes) * attributes.size(),
+               attributes.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-  glBindVertexArray(0);
+  m_numInstances = static_cast<GLsizei>(instances.size());
+}
+
+void Model::setMeshData(MeshData& data, GLuint program) {
+  m_vertices = std::move(data.vertices);
+  m_indices = std::move(data.indices);
+
+  m_hasNormals = data.info.hasNormals;
+  m_hasTexCoords = data.info.hasTexCoords;
+
+  m_Ka = data.info.Ka;
+  m_Kd = data.info.Kd;
+  m_Ks = data.info.Ks;
+  m_shininess = data.info.shininess;
+
+  if (!data.diffuseImage.pixels.empty()) {
+    glDeleteTextures(1, &m_diffuseTexture);
+    m_diffuseTexture = abcg::opengl::createTexture(data.diffuseImage);
+  }
+
+  createBuffers();
+
+  setupVAO(program);
 }
 
 void Model::setupVAO(GLuint program) {
@@ -261,18 +353,44 @@ void Model::setupVAO(GLuint program) {
                           sizeof(Vertex), reinterpret_cast<void*>(offset));
   }
 
+  // Bind per-instance attributes. Matrices take one location per column.
+  glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+  const auto bindInstanceAttribute{[program](const char* name, int columns,
+                                             GLint size, std::size_t offset) {
+    const auto location{glGetAttribLocation(program, name)};
+    if (location < 0) return;
+    for (const auto column : iter::range(columns)) {
+      const auto columnLocation{static_cast<GLuint>(location + column)};
+      const auto columnOffset{offset + column * size * sizeof(float)};
+      glEnableVertexAttribArray(columnLocation);
+      glVertexAttribPointer(columnLocation, size, GL_FLOAT, GL_FALSE,
+                            sizeof(InstanceAttributes),
+                            reinterpret_cast<void*>(columnOffset));
+      glVertexAttribDivisor(columnLocation, 1);
+    }
+  }};
+  bindInstanceAttribute("inModelMatrix", 4, 4,
+                        offsetof(InstanceAttributes, modelMatrix));
+  bindInstanceAttribute("inNormalMatrix", 3, 3,
+                        offsetof(InstanceAttributes, normalMatrix));
+  bindInstanceAttribute("inKa", 1, 4, offsetof(InstanceAttributes, Ka));
+  bindInstanceAttribute("inKd", 1, 4, offsetof(InstanceAttributes, Kd));
+  bindInstanceAttribute("inKs", 1, 4, offsetof(InstanceAttributes, Ks));
+  bindInstanceAttribute("inShininess", 1, 1,
+                        offsetof(InstanceAttributes, shininess));
+
   // End of binding
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
 }
 
-void Model::standardize() {
+void Model::standardize(MeshData& data) {
   // Center to origin and normalize largest bound to [-1, 1]
 
   // Get bounds
   glm::vec3 max(std::numeric_limits<float>::lowest());
   glm::vec3 min(std::numeric_limits<float>::max());
-  for (const auto& vertex : m_vertices) {
+  for (const auto& vertex : data.vertices) {
     max.x = std::max(max.x, vertex.position.x);
     max.y = std::max(max.y, vertex.position.y);
     max.z = std::max(max.z, vertex.position.z);
@@ -284,7 +402,7 @@ void Model::standardize() {
   // Center and scale
   const auto center{(min + max) / 2.0f};
   const auto scaling{2.0f / glm::length(max - min)};
-  for (auto& vertex : m_vertices) {
+  for (auto& vertex : data.vertices) {
     vertex.position = (vertex.position - center) * scaling;
   }
 }
\ No newline at end of file
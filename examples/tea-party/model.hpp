@@ -1,6 +1,8 @@
 #ifndef MODEL_HPP_
 #define MODEL_HPP_
 
+#include <span>
+
 #include "abcg.hpp"
 
 struct Vertex {
@@ -16,21 +18,54 @@ struct Vertex {
   }
 };
 
+// CPU-side data of a model, filled by Model::loadMeshData
+struct MeshData {
+  std::vector<Vertex> vertices;
+  std::vector<GLuint> indices;
+  abcg::MeshCacheInfo info;
+  abcg::ImageData diffuseImage;
+};
+
+// Transform and material of one copy of a model, set with
+// Model::setInstances and drawn with Model::renderInstanced
+struct ModelInstance {
+  glm::mat4 modelMatrix{1.0f};
+  glm::vec4 Ka{};
+  glm::vec4 Kd{};
+  glm::vec4 Ks{};
+  float shininess{};
+};
+
 class Model {
  public:
   Model() = default;
   virtual ~Model();
 
+  // Not movable, as the callbacks of pending asynchronous loads keep a
+  // pointer to the model
   Model(const Model&) = delete;
-  Model(Model&&) = default;
+  Model(Model&&) = delete;
   Model& operator=(const Model&) = delete;
-  Model& operator=(Model&&) = default;
+  Model& operator=(Model&&) = delete;
 
   void loadDiffuseTexture(std::string_view path);
+  void loadDiffuseTextureAsync(abcg::AssetLoader& loader,
+                               std::string_view path);
   void loadFromFile(std::string_view path, GLuint program,  bool standardize = true);
+  void loadFromFileAsync(abcg::AssetLoader& loader, std::string_view path,
+                         GLuint program, bool standardize = true);
+  void enqueue(
+      abcg::RenderQueue& queue, const abcg::ShaderProgram& program,
+      std::initializer_list<abcg::RenderQueue::Uniform> uniforms) const;
   void render(int numTriangles = -1) const;
+  void renderInstanced() const;
+  void setInstances(std::span<const ModelInstance> instances);
   void setupVAO(GLuint program);
 
+  [[nodiscard]] static MeshData loadMeshData(std::string_view path,
+                                             bool standardize = true,
+                                             unsigned int numThreads = 0);
+
   [[nodiscard]] int getNumTriangles() const {
     return static_cast<int>(m_indices.size()) / 3;
   }
@@ -46,11 +81,23 @@ class Model {
   GLuint m_VAO{};
   GLuint m_VBO{};
   GLuint m_EBO{};
-
-  glm::vec4 m_Ka;
-  glm::vec4 m_Kd;
-  glm::vec4 m_Ks;
-  float m_shininess;
+  GLuint m_instanceVBO{};
+
+  // Layout of the per-instance attributes in m_instanceVBO
+  struct InstanceAttributes {
+    glm::mat4 modelMatrix;
+    glm::mat3 normalMatrix;
+    glm::vec4 Ka;
+    glm::vec4 Kd;
+    glm::vec4 Ks;
+    float shininess;
+  };
+  GLsizei m_numInstances{};
+
+  glm::vec4 m_Ka{};
+  glm::vec4 m_Kd{};
+  glm::vec4 m_Ks{};
+  float m_shininess{};
   GLuint m_diffuseTexture{};
 
   std::vector<Vertex> m_vertices;
@@ -59,10 +106,14 @@ class Model {
   bool m_hasNormals{false};
   bool m_hasTexCoords{false};
 
-  void computeNormals();
+  static void computeNormals(MeshData& data);
+  static void parseObjFile(std::string_view path, MeshData& data,
+                           unsigned int numThreads);
+  static void standardize(MeshData& data);
 
+  void bindDiffuseTexture() const;
   void createBuffers();
-  void standardize();
+  void setMeshData(MeshData& data, GLuint program);
 };
 
 #endif
\ No newline at end of file
@@ -57,25 +57,79 @@ void OpenGLWindow::initializeGL() {
   m_programTexture = createProgramFromFile(getAssetsPath() + "texture.vert",
                                            getAssetsPath() + "texture.frag");
 
-  m_modelHeart.loadDiffuseTexture(getAssetsPath() + "maps/redpattern.png");
-  m_modelHeart.loadFromFile(getAssetsPath() + "12190_Heart_v1_L3.obj",
-                            m_programTexture);
+  m_programPhongInstanced =
+      createProgramFromFile(getAssetsPath() + "phonginstanced.vert",
+                            getAssetsPath() + "phonginstanced.frag");
 
-  m_modelFlyingSaucer.loadFromFile(
-      getAssetsPath() + "11681_Flying_saucer_v1_L3.obj", m_programTexture);
+  m_programNormalInstanced =
+      createProgramFromFile(getAssetsPath() + "normalinstanced.vert",
+                            getAssetsPath() + "normal.frag");
 
-  m_modelTree.loadFromFile(getAssetsPath() + "Tree2.obj", m_programNormal);
+  // Camera and light state shared by all programs
+  m_frameUniforms.create(sizeof(abcg::FrameUniforms),
+                         abcg::FrameUniforms::binding);
 
-  m_modelBunny.loadFromFile(getAssetsPath() + "bunny.obj", m_programPhong);
+  // Models are parsed on worker threads and uploaded over the next frames
+  auto& loader{getAssetLoader()};
 
-  m_modelTeapot.loadFromFile(getAssetsPath() + "teapot.obj", m_programNormal);
+  m_modelHeart.loadDiffuseTextureAsync(loader,
+                                       getAssetsPath() + "maps/redpattern.png");
+  m_modelHeart.loadFromFileAsync(
+      loader, getAssetsPath() + "12190_Heart_v1_L3.obj", m_programTexture);
 
-  m_modelTRex.loadDiffuseTexture(getAssetsPath() + "maps/rainbow.png");
-  m_modelTRex.loadFromFile(getAssetsPath() + "T-Rex Model.obj", m_programPhong);
+  m_modelFlyingSaucer.loadFromFileAsync(
+      loader, getAssetsPath() + "11681_Flying_saucer_v1_L3.obj",
+      m_programTexture);
+
+  m_modelTree.loadFromFileAsync(loader, getAssetsPath() + "Tree2.obj",
+                                m_programNormalInstanced);
+
+  m_modelBunny.loadFromFileAsync(loader, getAssetsPath() + "bunny.obj",
+                                 m_programPhongInstanced);
+
+  m_modelTeapot.loadFromFileAsync(loader, getAssetsPath() + "teapot.obj",
+                                  m_programNormal);
+
+  m_modelTRex.loadDiffuseTextureAsync(loader,
+                                      getAssetsPath() + "maps/rainbow.png");
+  m_modelTRex.loadFromFileAsync(loader, getAssetsPath() + "T-Rex Model.obj",
+                                m_programPhong);
+
+  initializeInstances();
 
   resizeGL(getWindowSettings().width, getWindowSettings().height);
 }
 
+void OpenGLWindow::initializeInstances() {
+  const auto transform{[](glm::vec3 translation, float angle, float scale) {
+    glm::mat4 model{1.0f};
+    model = glm::translate(model, translation);
+    model = glm::rotate(model, glm::radians(angle), glm::vec3(0, 1, 0));
+    return glm::scale(model, glm::vec3(scale));
+  }};
+
+  // Green, white, pink and orange bunnies
+  const glm::vec4 ka{0.1f, 0.1f, 0.1f, 1.0f};
+  const std::vector<ModelInstance> bunnyInstances{
+      {transform({-1.0f, 0.0f, 0.0f}, 90.0f, 0.5f), ka,
+       glm::vec4{0.0f, 1.0f, 0.0f, 1.0f}, m_Ks, 12.5f},
+      {transform({3.0f, 0.0f, 0.0f}, -90.0f, 0.5f), m_Ka, m_Kd, m_Ks,
+       m_shininess},
+      {transform({4.0f, 0.0f, 2.0f}, -120.0f, 0.6f), m_Ka,
+       glm::vec4{1.0f, 0.0f, 0.5f, 1.0f}, m_Ks, m_shininess},
+      {transform({2.0f, 0.0f, 1.3f}, -150.0f, 0.4f), m_Ka,
+       glm::vec4{1.0f, 0.5f, 0.0f, 1.0f}, m_Ks, m_shininess}};
+  m_modelBunny.setInstances(bunnyInstances);
+
+  // Trees are colored by their normals; no material is needed
+  const std::vector<ModelInstance> treeInstances{
+      {transform({2.0f, 0.0f, -2.0f}, -210.0f, 0.6f)},
+      {transform({-2.0f, 0.0f, -1.0f}, -180.0f, 0.9f)},
+      {transform({-1.0f, 0.0f, -1.7f}, -90.0f, 0.6f)},
+      {transform({-1.5f, 0.0f, 2.7f}, 0.0f, 0.6f)}};
+  m_modelTree.setInstances(treeInstances);
+}
+
 void OpenGLWindow::paintGL() {
   glClearColor(m_camera.m_at.r * 0.3, m_camera.m_at.g * 0.3, m_camera.m_at.b * 0.3, 1);
   update();
@@ -85,134 +139,49 @@ void OpenGLWindow::paintGL() {
 
   glViewport(0, 0, m_viewportWidth, m_viewportHeight);
 
-  glUseProgram(m_programPhong);
-  paintPhongIlluminatedModels();
-
-  glUseProgram(m_programTexture);
+  // Update camera and light state once for every program
+  abcg::FrameUniforms frameUniforms;
+  frameUniforms.viewMatrix = m_camera.m_viewMatrix;
+  frameUniforms.projMatrix = m_camera.m_projMatrix;
+  frameUniforms.lightDirWorldSpace = m_lightDir;
+  frameUniforms.Ia = m_Ia;
+  frameUniforms.Id = m_Id;
+  frameUniforms.Is = m_Is;
+  m_frameUniforms.update(frameUniforms);
+
+  // Draw all bunnies with a single call
+  glUseProgram(m_programPhongInstanced);
+  m_modelBunny.renderInstanced();
+
+  // Draws of single models are sorted by program, texture and VAO
   paintModelsWithTexture();
-
-  glUseProgram(m_programNormal);
   paintNormalModels();
+  m_renderQueue.submit();
 
-  glUseProgram(0);
-}
-
-void OpenGLWindow::paintPhongIlluminatedModels() {
-  // Get location of uniform variables (could be precomputed)
-  GLint viewMatrixLoc{glGetUniformLocation(m_programPhong, "viewMatrix")};
-  GLint projMatrixLoc{glGetUniformLocation(m_programPhong, "projMatrix")};
-  GLint modelMatrixLoc{glGetUniformLocation(m_programPhong, "modelMatrix")};
-  GLint colorLoc{glGetUniformLocation(m_programPhong, "color")};
-
-  // Get location of uniform variables
-  GLint normalMatrixLoc{glGetUniformLocation(m_programPhong, "normalMatrix")};
-  GLint lightDirLoc{glGetUniformLocation(m_programPhong, "lightDirWorldSpace")};
-  GLint shininessLoc{glGetUniformLocation(m_programPhong, "shininess")};
-  GLint IaLoc{glGetUniformLocation(m_programPhong, "Ia")};
-  GLint IdLoc{glGetUniformLocation(m_programPhong, "Id")};
-  GLint IsLoc{glGetUniformLocation(m_programPhong, "Is")};
-  GLint KaLoc{glGetUniformLocation(m_programPhong, "Ka")};
-  GLint KdLoc{glGetUniformLocation(m_programPhong, "Kd")};
-  GLint KsLoc{glGetUniformLocation(m_programPhong, "Ks")};
-
-  // Set uniform variables for viewMatrix and projMatrix
-  // These matrices are used for every scene object
-  glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, &m_camera.m_viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, &m_camera.m_projMatrix[0][0]);
-
-  glm::vec4 ka{0.1f, 0.1f, 0.1f, 1.0f};
-  glm::vec4 kd{0.0f, 1.0f, 0.0f, 1.0f};
-  auto lightDirRotated{m_lightDir};
-  glUniform4fv(lightDirLoc, 1, &lightDirRotated.x);
-  glUniform1f(shininessLoc, 12.5f);
-  glUniform4fv(IaLoc, 1, &m_Ia.x);
-  glUniform4fv(IdLoc, 1, &m_Id.x);
-  glUniform4fv(IsLoc, 1, &m_Is.x);
-  glUniform4fv(KaLoc, 1, &ka.x);
-  glUniform4fv(KdLoc, 1, &kd.x);
-  glUniform4fv(KsLoc, 1, &m_Ks.x);
-
-  // Draw green bunny
-  glm::mat4 model{1.0f};
-  model = glm::translate(model, glm::vec3(-1.0f, 0.0f, 0.0f));
-  model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.5f));
-
-  glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &model[0][0]);
-
-  auto modelViewMatrix{glm::mat3(m_camera.m_viewMatrix * model)};
-  glm::mat3 normalMatrix{glm::inverseTranspose(modelViewMatrix)};
-  glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, &normalMatrix[0][0]);
-  glUniform4f(colorLoc, 0.0f, 1.0f, 0.0f, 1.0f);
-
-  m_modelBunny.render(-1);
-
-  glUniform1f(shininessLoc, m_shininess);
-  glUniform4fv(KaLoc, 1, &m_Ka.x);
-  glUniform4fv(KdLoc, 1, &m_Kd.x);
-  // Draw white bunny
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(3.0f, 0.0f, 0.0f));
-  model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.5f));
-
-  glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &model[0][0]);
-  glUniform4f(colorLoc, 0.0f, 1.0f, 0.0f, 1.0f);
-  m_modelBunny.render(-1);
-
-  kd = {1.0f, 0.0f, 0.5f, 1.0f};
-  glUniform1f(shininessLoc, m_shininess);
-  glUniform4fv(KdLoc, 1, &kd.x);
-
-  // Draw pink bunny
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(4.0f, 0.0f, 2.0f));
-  model = glm::rotate(model, glm::radians(-120.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.6f));
+  // Draw all trees with a single call
+  glUseProgram(m_programNormalInstanced);
+  m_modelTree.renderInstanced();
 
-  glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &model[0][0]);
-  glUniform4f(colorLoc, 0.0f, 1.0f, 0.0f, 1.0f);
-  m_modelBunny.render(-1);
-
-  kd = {1.0f, 0.5f, 0.0f, 1.0f};
-  glUniform1f(shininessLoc, m_shininess);
-  glUniform4fv(KdLoc, 1, &kd.x);
-
-  // Draw orange bunny
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(2.0f, 0.0f, 1.3f));
-  model = glm::rotate(model, glm::radians(-150.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.4f));
-
-  glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &model[0][0]);
-  glUniform4f(colorLoc, 0.0f, 1.0f, 0.0f, 1.0f);
-  m_modelBunny.render(-1);
+  glUseProgram(0);
 }
 
 void OpenGLWindow::paintModelsWithTexture() {
-  GLint diffuseTexLocTexture{
-      glGetUniformLocation(m_programTexture, "diffuseTex")};
-  GLint mappingModeLocTexture{
-      glGetUniformLocation(m_programTexture, "mappingMode")};
-  GLint viewMatrixLocTexture{
-      glGetUniformLocation(m_programTexture, "viewMatrix")};
-  GLint projMatrixLocTexture{
-      glGetUniformLocation(m_programTexture, "projMatrix")};
-  GLint modelMatrixLocTexture{
-      glGetUniformLocation(m_programTexture, "modelMatrix")};
-  GLint normalMatrixLocTexture{
-      glGetUniformLocation(m_programTexture, "normalMatrix")};
-  GLint lightDirLocTexture{
-      glGetUniformLocation(m_programTexture, "lightDirWorldSpace")};
-  GLint shininessLocTexture{
-      glGetUniformLocation(m_programTexture, "shininess")};
-  GLint IaLocTexture{glGetUniformLocation(m_programTexture, "Ia")};
-  GLint IdLocTexture{glGetUniformLocation(m_programTexture, "Id")};
-  GLint IsLocTexture{glGetUniformLocation(m_programTexture, "Is")};
-  GLint KaLocTexture{glGetUniformLocation(m_programTexture, "Ka")};
-  GLint KdLocTexture{glGetUniformLocation(m_programTexture, "Kd")};
-  GLint KsLocTexture{glGetUniformLocation(m_programTexture, "Ks")};
-  GLint colorLoc{glGetUniformLocation(m_programTexture, "color")};
+  const auto enqueueModel{[&](const Model& mesh, const glm::mat4& model,
+                              const glm::vec4& color) {
+    auto modelViewMatrix{glm::mat3(m_camera.m_viewMatrix * model)};
+    glm::mat3 normalMatrix{glm::inverseTranspose(modelViewMatrix)};
+
+    mesh.enqueue(m_renderQueue, m_programTexture,
+                 {{"diffuseTex", 0},
+                  {"mappingMode", 3},  // mesh
+                  {"modelMatrix", model},
+                  {"normalMatrix", normalMatrix},
+                  {"shininess", mesh.getShininess()},
+                  {"Ka", mesh.getKa()},
+                  {"Kd", mesh.getKd()},
+                  {"Ks", mesh.getKs()},
+                  {"color", color}});
+  }};
 
   // Draw red heart
   glm::mat4 model{1.0f};
@@ -220,162 +189,35 @@ void OpenGLWindow::paintModelsWithTexture() {
   model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1, 0, 0));
   model = glm::scale(model, glm::vec3(0.3f));
 
-  glUniformMatrix4fv(modelMatrixLocTexture, 1, GL_FALSE, &model[0][0]);
-
-  glUniformMatrix4fv(viewMatrixLocTexture, 1, GL_FALSE,
-                     &m_camera.m_viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLocTexture, 1, GL_FALSE,
-                     &m_camera.m_projMatrix[0][0]);
-  glUniform1i(diffuseTexLocTexture, 0);
-  glUniform1i(mappingModeLocTexture, 3);  // mesh
-  glUniform4f(colorLoc, 1.0f, 0.25f, 0.25f, 1.0f);
+  enqueueModel(m_modelHeart, model, {1.0f, 0.25f, 0.25f, 1.0f});
 
-  glUniform4fv(lightDirLocTexture, 1, &m_lightDir.x);
-  glUniform4fv(IaLocTexture, 1, &m_Ia.x);
-  glUniform4fv(IdLocTexture, 1, &m_Id.x);
-  glUniform4fv(IsLocTexture, 1, &m_Is.x);
-
-  auto modelViewMatrixTexture{glm::mat3(m_camera.m_viewMatrix * model)};
-  glm::mat3 textureMatrix{glm::inverseTranspose(modelViewMatrixTexture)};
-  glUniformMatrix3fv(normalMatrixLocTexture, 1, GL_FALSE, &textureMatrix[0][0]);
-
-  auto ka = m_modelHeart.getKa();
-  auto kd = m_modelHeart.getKd();
-  auto ks = m_modelHeart.getKs();
-
-  glUniform1f(shininessLocTexture, m_modelHeart.getShininess());
-  glUniform4fv(KaLocTexture, 1, &ka.x);
-  glUniform4fv(KdLocTexture, 1, &kd.x);
-  glUniform4fv(KsLocTexture, 1, &ks.x);
-
-  m_modelHeart.render(-1);
-  // // Draw orange t-rex
+  // Draw orange t-rex
   model = glm::mat4(1.0);
   model = glm::translate(model, glm::vec3(0.0f, 0.0f, -1.0f));
   model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0, 1, 0));
   model = glm::scale(model, glm::vec3(1.0f));
-  glUniformMatrix4fv(modelMatrixLocTexture, 1, GL_FALSE, &model[0][0]);
-
-  glUniformMatrix4fv(viewMatrixLocTexture, 1, GL_FALSE,
-                     &m_camera.m_viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLocTexture, 1, GL_FALSE,
-                     &m_camera.m_projMatrix[0][0]);
-  glUniform1i(diffuseTexLocTexture, 0);
-  glUniform1i(mappingModeLocTexture, 3);  // mesh
-  glUniform4f(colorLoc, 1.0f, 0.25f, 0.25f, 1.0f);
-
-  glUniform4fv(lightDirLocTexture, 1, &m_lightDir.x);
-  glUniform4fv(IaLocTexture, 1, &m_Ia.x);
-  glUniform4fv(IdLocTexture, 1, &m_Id.x);
-  glUniform4fv(IsLocTexture, 1, &m_Is.x);
-
-  modelViewMatrixTexture = glm::mat3(m_camera.m_viewMatrix * model);
-  textureMatrix = glm::inverseTranspose(modelViewMatrixTexture);
-  glUniformMatrix3fv(normalMatrixLocTexture, 1, GL_FALSE, &textureMatrix[0][0]);
-
-  ka = m_modelTRex.getKa();
-  kd = m_modelTRex.getKd();
-  ks = m_modelTRex.getKs();
-
-  glUniform1f(shininessLocTexture, m_modelTRex.getShininess());
-  glUniform4fv(KaLocTexture, 1, &ka.x);
-  glUniform4fv(KdLocTexture, 1, &kd.x);
-  glUniform4fv(KsLocTexture, 1, &ks.x);
-
-  glUniformMatrix4fv(modelMatrixLocTexture, 1, GL_FALSE, &model[0][0]);
-  glUniform4f(colorLoc, 1.0f, 0.5f, 0.0f, 1.0f);
-  m_modelTRex.render(-1);
+
+  enqueueModel(m_modelTRex, model, {1.0f, 0.5f, 0.0f, 1.0f});
 
   model = glm::mat4(1.0);
   model = glm::translate(model, glm::vec3(1.0f, 0.8f, -2.0f));
   model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(1, 0, 0));
   // model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0, 1, 0));
   model = glm::scale(model, glm::vec3(1.0f));
-  glUniformMatrix4fv(modelMatrixLocTexture, 1, GL_FALSE, &model[0][0]);
-
-  glUniformMatrix4fv(viewMatrixLocTexture, 1, GL_FALSE,
-                     &m_camera.m_viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLocTexture, 1, GL_FALSE,
-                     &m_camera.m_projMatrix[0][0]);
-  glUniform1i(diffuseTexLocTexture, 0);
-  glUniform1i(mappingModeLocTexture, 3);  // mesh
-  glUniform4f(colorLoc, 1.0f, 0.25f, 0.25f, 1.0f);
-
-  glUniform4fv(lightDirLocTexture, 1, &m_lightDir.x);
-  glUniform4fv(IaLocTexture, 1, &m_Ia.x);
-  glUniform4fv(IdLocTexture, 1, &m_Id.x);
-  glUniform4fv(IsLocTexture, 1, &m_Is.x);
-
-  modelViewMatrixTexture = glm::mat3(m_camera.m_viewMatrix * model);
-  textureMatrix = glm::inverseTranspose(modelViewMatrixTexture);
-  glUniformMatrix3fv(normalMatrixLocTexture, 1, GL_FALSE, &textureMatrix[0][0]);
-
-  ka = m_modelFlyingSaucer.getKa();
-  kd = m_modelFlyingSaucer.getKd();
-  ks = m_modelFlyingSaucer.getKs();
-
-  glUniform1f(shininessLocTexture, m_modelFlyingSaucer.getShininess());
-  glUniform4fv(KaLocTexture, 1, &ka.x);
-  glUniform4fv(KdLocTexture, 1, &kd.x);
-  glUniform4fv(KsLocTexture, 1, &ks.x);
-
-  glUniformMatrix4fv(modelMatrixLocTexture, 1, GL_FALSE, &model[0][0]);
-  glUniform4f(colorLoc, 1.0f, 0.5f, 0.0f, 1.0f);
-  m_modelFlyingSaucer.render(-1);
+
+  enqueueModel(m_modelFlyingSaucer, model, {1.0f, 0.5f, 0.0f, 1.0f});
 }
 
 void OpenGLWindow::paintNormalModels() {
-  // Get location of uniform variables (could be precomputed)
-  GLint viewMatrixLocNormal{
-      glGetUniformLocation(m_programNormal, "viewMatrix")};
-  GLint projMatrixLocNormal{
-      glGetUniformLocation(m_programNormal, "projMatrix")};
-  GLint modelMatrixLocNormal{
-      glGetUniformLocation(m_programNormal, "modelMatrix")};
-  GLint colorLocNormal{glGetUniformLocation(m_programNormal, "color")};
-
-  // These matrices are used for every scene object
-  glUniformMatrix4fv(viewMatrixLocNormal, 1, GL_FALSE,
-                     &m_camera.m_viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLocNormal, 1, GL_FALSE,
-                     &m_camera.m_projMatrix[0][0]);
-
   // Draw gray Teapot
   glm::mat4 model{1.0f};
   model = glm::translate(model, glm::vec3(1.0f, 0.0f, 1.0f));
   // model = glm::rotate(model, glm::radians(90.0f), glm::vec3(0, 1, 0));
   model = glm::scale(model, glm::vec3(0.25f));
 
-  glUniformMatrix4fv(modelMatrixLocNormal, 1, GL_FALSE, &model[0][0]);
-  glUniform4f(colorLocNormal, 0.5f, 0.5f, 0.5f, 1.0f);
-  m_modelTeapot.render(-1);
-
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(2.0f, 0.0f, -2.0f));
-  model = glm::rotate(model, glm::radians(-210.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.6f));
-  glUniformMatrix4fv(modelMatrixLocNormal, 1, GL_FALSE, &model[0][0]);
-  m_modelTree.render(-1);
-
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(-2.0f, 0.0f, -1.0f));
-  model = glm::rotate(model, glm::radians(-180.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.9f));
-  glUniformMatrix4fv(modelMatrixLocNormal, 1, GL_FALSE, &model[0][0]);
-  m_modelTree.render(-1);
-
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(-1.0f, 0.0f, -1.7f));
-  model = glm::rotate(model, glm::radians(-90.0f), glm::vec3(0, 1, 0));
-  model = glm::scale(model, glm::vec3(0.6f));
-  glUniformMatrix4fv(modelMatrixLocNormal, 1, GL_FALSE, &model[0][0]);
-  m_modelTree.render(-1);
-
-  model = glm::mat4(1.0);
-  model = glm::translate(model, glm::vec3(-1.5f, 0.0f, 2.7f));
-  model = glm::scale(model, glm::vec3(0.6f));
-  glUniformMatrix4fv(modelMatrixLocNormal, 1, GL_FALSE, &model[0][0]);
-  m_modelTree.render(-1);
+  m_modelTeapot.enqueue(m_renderQueue, m_programNormal,
+                        {{"modelMatrix", model},
+                         {"color", glm::vec4{0.5f, 0.5f, 0.5f, 1.0f}}});
 }
 
 void OpenGLWindow::paintUI() {
@@ -389,6 +231,9 @@ void OpenGLWindow::paintUI() {
 
     ImGui::Text("Movimente a câmera com as setas");
     ImGui::Text("e com as teclas q, w, e, a, s, d");
+    if (const auto pending{getAssetLoader().getPendingCount()}; pending > 0) {
+      ImGui::Text("Carregando... (%zu)", pending);
+    }
 
     ImGui::End();
   }
@@ -409,4 +254,11 @@ void OpenGLWindow::resizeGL(int width, int height) {
   m_camera.computeProjectionMatrix(width, height);
 }
 
-void OpenGLWindow::terminateGL() { glDeleteProgram(m_programPhong); }
\ No newline at end of file
+void OpenGLWindow::terminateGL() {
+  m_frameUniforms.destroy();
+  glDeleteProgram(m_programPhong);
+  glDeleteProgram(m_programNormal);
+  glDeleteProgram(m_programTexture);
+  glDeleteProgram(m_programPhongInstanced);
+  glDeleteProgram(m_programNormalInstanced);
+}
\ No newline at end of file
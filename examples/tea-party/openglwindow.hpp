@@ -15,9 +15,13 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   void terminateGL() override;
 
  private:
-  GLuint m_programNormal{};
-  GLuint m_programPhong{};
-  GLuint m_programTexture{};
+  abcg::ShaderProgram m_programNormal;
+  abcg::ShaderProgram m_programPhong;
+  abcg::ShaderProgram m_programTexture;
+  abcg::ShaderProgram m_programPhongInstanced;
+  abcg::ShaderProgram m_programNormalInstanced;
+  abcg::UniformBuffer m_frameUniforms;
+  abcg::RenderQueue m_renderQueue;
 
   int m_viewportWidth{};
   int m_viewportHeight{};
@@ -45,7 +49,7 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   glm::vec4 m_Ks{1.0f, 1.0f, 1.0f, 1.0f};
   float m_shininess{25.0f};
 
-  void paintPhongIlluminatedModels();
+  void initializeInstances();
   void paintModelsWithTexture();
   void paintNormalModels();
   void update();
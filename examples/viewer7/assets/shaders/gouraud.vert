@@ -3,15 +3,17 @@
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 
+// Per-frame camera and light properties
+layout(std140) uniform FrameUniforms {
+  highp mat4 viewMatrix;
+  highp mat4 projMatrix;
+  highp vec4 lightDirWorldSpace;
+  highp vec4 Ia, Id, Is;
+};
+
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 projMatrix;
 uniform mat3 normalMatrix;
 
-// Light properties
-uniform vec4 lightDirWorldSpace;
-uniform vec4 Ia, Id, Is;
-
 // Material properties
 uniform vec4 Ka, Kd, Ks;
 uniform float shininess;
@@ -7,8 +7,13 @@ in vec2 fragTexCoord;
 in vec3 fragPObj;
 in vec3 fragNObj;
 
-// Light properties
-uniform vec4 Ia, Id, Is;
+// Per-frame camera and light properties
+layout(std140) uniform FrameUniforms {
+  highp mat4 viewMatrix;
+  highp mat4 projMatrix;
+  highp vec4 lightDirWorldSpace;
+  highp vec4 Ia, Id, Is;
+};
 
 // Material properties
 uniform vec4 Ka, Kd, Ks;
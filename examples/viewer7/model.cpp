@@ -1,25 +1,9 @@
 #include "model.hpp"
 
 #include <fmt/core.h>
-#include <tiny_obj_loader.h>
 
 #include <cppitertools/itertools.hpp>
 #include <filesystem>
-#include <glm/gtx/hash.hpp>
-#include <unordered_map>
-
-// Custom specialization of std::hash injected in namespace std
-namespace std {
-template <>
-struct hash<Vertex> {
-  size_t operator()(Vertex const& vertex) const noexcept {
-    std::size_t h1{std::hash<glm::vec3>()(vertex.position)};
-    std::size_t h2{std::hash<glm::vec3>()(vertex.normal)};
-    std::size_t h3{std::hash<glm::vec2>()(vertex.texCoord)};
-    return h1 ^ h2 ^ h3;
-  }
-};
-}  // namespace std
 
 Model::~Model() {
   glDeleteTextures(1, &m_cubeTexture);
@@ -171,27 +155,36 @@ void Model::loadNormalTexture(std::string_view path) {
 void Model::loadFromFile(std::string_view path, bool standardize) {
   auto basePath{std::filesystem::path{path}.parent_path().string() + "/"};
 
-  tinyobj::ObjReaderConfig readerConfig;
-  readerConfig.mtl_search_path = basePath;  // Path to material files
+  // Try the binary cache first; parse the OBJ file only on a cache miss
+  abcg::MeshCacheInfo info{};
+  if (const abcg::MeshCache cache{path, standardize ? 1U : 0U};
+      !cache.read(m_vertices, m_indices, info)) {
+    info = parseObjFile(path, standardize);
+    cache.write(m_vertices, m_indices, info);
+  }
 
-  tinyobj::ObjReader reader;
+  m_hasNormals = info.hasNormals;
+  m_hasTexCoords = info.hasTexCoords;
 
-  if (!reader.ParseFromFile(path.data(), readerConfig)) {
-    if (!reader.Error().empty()) {
-      throw abcg::Exception{abcg::Exception::Runtime(
-          fmt::format("Failed to load model {} ({})", path, reader.Error()))};
-    }
-    throw abcg::Exception{
-        abcg::Exception::Runtime(fmt::format("Failed to load model {}", path))};
-  }
+  m_Ka = info.Ka;
+  m_Kd = info.Kd;
+  m_Ks = info.Ks;
+  m_shininess = info.shininess;
 
-  if (!reader.Warning().empty()) {
-    fmt::print("Warning: {}\n", reader.Warning());
-  }
+  if (!info.diffuseTexName.empty())
+    loadDiffuseTexture(basePath + info.diffuseTexName);
+
+  if (!info.normalTexName.empty())
+    loadNormalTexture(basePath + info.normalTexName);
+
+  createBuffers();
+}
 
-  const auto& attrib{reader.GetAttrib()};
-  const auto& shapes{reader.GetShapes()};
-  const auto& materials{reader.GetMaterials()};
+abcg::MeshCacheInfo Model::parseObjFile(std::string_view path,
+                                        bool standardize) {
+  // Parse the file using all hardware threads
+  const auto mesh{abcg::importObjFile(path)};
+  const auto& materials{mesh.materials};
 
   m_vertices.clear();
   m_indices.clear();
@@ -199,83 +192,72 @@ void Model::loadFromFile(std::string_view path, bool standardize) {
   m_hasNormals = false;
   m_hasTexCoords = false;
 
-  // A key:value map with key=Vertex and value=index
-  std::unordered_map<Vertex, GLuint> hash{};
-
-  // Loop over shapes
-  for (const auto& shape : shapes) {
-    // Loop over indices
-    for (const auto offset : iter::range(shape.mesh.indices.size())) {
-      // Access to vertex
-      tinyobj::index_t index{shape.mesh.indices.at(offset)};
-
-      // Vertex position
-      std::size_t startIndex{static_cast<size_t>(3 * index.vertex_index)};
-      float vx{attrib.vertices.at(startIndex + 0)};
-      float vy{attrib.vertices.at(startIndex + 1)};
-      float vz{attrib.vertices.at(startIndex + 2)};
-
-      // Vertex normal
-      float nx{};
-      float ny{};
-      float nz{};
-      if (index.normal_index >= 0) {
-        m_hasNormals = true;
-        startIndex = 3 * index.normal_index;
-        nx = attrib.normals.at(startIndex + 0);
-        ny = attrib.normals.at(startIndex + 1);
-        nz = attrib.normals.at(startIndex + 2);
-      }
-
-      // Vertex texture coordinates
-      float tu{};
-      float tv{};
-      if (index.texcoord_index >= 0) {
-        m_hasTexCoords = true;
-        startIndex = 2 * index.texcoord_index;
-        tu = attrib.texcoords.at(startIndex + 0);
-        tv = attrib.texcoords.at(startIndex + 1);
-      }
-
-      Vertex vertex{};
-      vertex.position = {vx, vy, vz};
-      vertex.normal = {nx, ny, nz};
-      vertex.texCoord = {tu, tv};
-
-      // If hash doesn't contain this vertex
-      if (hash.count(vertex) == 0) {
-        // Add this index (size of m_vertices)
-        hash[vertex] = m_vertices.size();
-        // Add this vertex
-        m_vertices.push_back(vertex);
-      }
-
-      m_indices.push_back(hash[vertex]);
+  // Merges duplicate vertices into m_vertices
+  abcg::VertexWelder<Vertex> welder{m_vertices};
+
+  // Loop over indices
+  for (const auto& index : mesh.indices) {
+    // Vertex position
+    std::size_t startIndex{static_cast<size_t>(3 * index.vertex_index)};
+    float vx{mesh.vertices.at(startIndex + 0)};
+    float vy{mesh.vertices.at(startIndex + 1)};
+    float vz{mesh.vertices.at(startIndex + 2)};
+
+    // Vertex normal
+    float nx{};
+    float ny{};
+    float nz{};
+    if (index.normal_index >= 0) {
+      m_hasNormals = true;
+      startIndex = 3 * index.normal_index;
+      nx = mesh.normals.at(startIndex + 0);
+      ny = mesh.normals.at(startIndex + 1);
+      nz = mesh.normals.at(startIndex + 2);
     }
+
+    // Vertex texture coordinates
+    float tu{};
+    float tv{};
+    if (index.texcoord_index >= 0) {
+      m_hasTexCoords = true;
+      startIndex = 2 * index.texcoord_index;
+      tu = mesh.texcoords.at(startIndex + 0);
+      tv = mesh.texcoords.at(startIndex + 1);
+    }
+
+    Vertex vertex{};
+    vertex.position = {vx, vy, vz};
+    vertex.normal = {nx, ny, nz};
+    vertex.texCoord = {tu, tv};
+
+    m_indices.push_back(welder.insert(vertex));
   }
 
+  abcg::MeshCacheInfo info{};
+
+  // The cache checks these files to detect edited materials
+  info.materialLibraries = mesh.materialLibraries;
+
   // Use properties of first material, if available
   if (!materials.empty()) {
     const auto& mat{materials.at(0)};  // First material
-    m_Ka = glm::vec4(mat.ambient[0], mat.ambient[1], mat.ambient[2], 1);
-    m_Kd = glm::vec4(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2], 1);
-    m_Ks = glm::vec4(mat.specular[0], mat.specular[1], mat.specular[2], 1);
-    m_shininess = mat.shininess;
-
-    if (!mat.diffuse_texname.empty())
-      loadDiffuseTexture(basePath + mat.diffuse_texname);
+    info.Ka = glm::vec4(mat.ambient[0], mat.ambient[1], mat.ambient[2], 1);
+    info.Kd = glm::vec4(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2], 1);
+    info.Ks = glm::vec4(mat.specular[0], mat.specular[1], mat.specular[2], 1);
+    info.shininess = mat.shininess;
+    info.diffuseTexName = mat.diffuse_texname;
 
     if (!mat.normal_texname.empty()) {
-      loadNormalTexture(basePath + mat.normal_texname);
+      info.normalTexName = mat.normal_texname;
     } else if (!mat.bump_texname.empty()) {
-      loadNormalTexture(basePath + mat.bump_texname);
+      info.normalTexName = mat.bump_texname;
     }
   } else {
     // Default values
-    m_Ka = {0.1f, 0.1f, 0.1f, 1.0f};
-    m_Kd = {0.7f, 0.7f, 0.7f, 1.0f};
-    m_Ks = {1.0f, 1.0f, 1.0f, 1.0f};
-    m_shininess = 25.0f;
+    info.Ka = {0.1f, 0.1f, 0.1f, 1.0f};
+    info.Kd = {0.7f, 0.7f, 0.7f, 1.0f};
+    info.Ks = {1.0f, 1.0f, 1.0f, 1.0f};
+    info.shininess = 25.0f;
   }
 
   if (standardize) {
@@ -290,7 +272,10 @@ void Model::loadFromFile(std::string_view path, bool standardize) {
     computeTangents();
   }
 
-  createBuffers();
+  info.hasNormals = m_hasNormals;
+  info.hasTexCoords = m_hasTexCoords;
+
+  return info;
 }
 
 void Model::render(int numTriangles) const {
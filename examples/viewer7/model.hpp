@@ -70,6 +70,7 @@ class Model {
 
   void computeNormals();
   void computeTangents();
+  abcg::MeshCacheInfo parseObjFile(std::string_view path, bool standardize);
   void createBuffers();
   void standardize();
 };
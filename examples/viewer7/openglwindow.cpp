@@ -41,19 +41,33 @@ void OpenGLWindow::initializeGL() {
   glClearColor(0, 0, 0, 1);
   glEnable(GL_DEPTH_TEST);
 
-  // Create programs
+  // Submit all programs before waiting for any of them, so that drivers
+  // with background compiler threads can build them in parallel
+  std::vector<abcg::ProgramFuture> programs;
   for (const auto& name : m_shaderNames) {
     auto path{getAssetsPath() + "shaders/" + name};
-    auto program{createProgramFromFile(path + ".vert", path + ".frag")};
-    m_programs.push_back(program);
+    programs.push_back(
+        createProgramFromFileAsync(path + ".vert", path + ".frag"));
   }
+  auto skyPath{getAssetsPath() + "shaders/" + m_skyShaderName};
+  auto skyProgram{
+      createProgramFromFileAsync(skyPath + ".vert", skyPath + ".frag")};
 
-  // Load default model
-  loadModel(getAssetsPath() + "bunny.obj");
+  // Camera and light state shared by all programs
+  m_frameUniforms.create(sizeof(abcg::FrameUniforms),
+                         abcg::FrameUniforms::binding);
 
-  // Load cubemap
+  // Load cubemap while the programs are being built
   m_model.loadCubeTexture(getAssetsPath() + "maps/cube/");
 
+  for (auto& program : programs) {
+    m_programs.push_back(program.get());
+  }
+  m_skyProgram = skyProgram.get();
+
+  // Load default model
+  loadModel(getAssetsPath() + "bunny.obj");
+
   // Initial trackball spin
   m_trackBallModel.setAxis(glm::normalize(glm::vec3(1, 1, 1)));
   m_trackBallModel.setVelocity(0.0001f);
@@ -62,10 +76,6 @@ void OpenGLWindow::initializeGL() {
 }
 
 void OpenGLWindow::initializeSkybox() {
-  // Create skybox program
-  auto path{getAssetsPath() + "shaders/" + m_skyShaderName};
-  m_skyProgram = createProgramFromFile(path + ".vert", path + ".frag");
-
   // Generate VBO
   glGenBuffers(1, &m_skyVBO);
   glBindBuffer(GL_ARRAY_BUFFER, m_skyVBO);
@@ -74,7 +84,7 @@ void OpenGLWindow::initializeSkybox() {
   glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Get location of attributes in the program
-  GLint positionAttribute{glGetAttribLocation(m_skyProgram, "inPosition")};
+  GLint positionAttribute{m_skyProgram.getAttribLocation("inPosition")};
 
   // Create VAO
   glGenVertexArrays(1, &m_skyVAO);
@@ -111,60 +121,48 @@ void OpenGLWindow::paintGL() {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   glViewport(0, 0, m_viewportWidth, m_viewportHeight);
 
+  // Update camera and light state once for every program
+  abcg::FrameUniforms frameUniforms;
+  frameUniforms.viewMatrix = m_viewMatrix;
+  frameUniforms.projMatrix = m_projMatrix;
+  frameUniforms.lightDirWorldSpace =
+      m_trackBallLight.getRotation() * m_lightDir;
+  frameUniforms.Ia = m_Ia;
+  frameUniforms.Id = m_Id;
+  frameUniforms.Is = m_Is;
+  m_frameUniforms.update(frameUniforms);
+
   // Use currently selected program
-  const auto program{m_programs.at(m_currentProgramIndex)};
+  const auto& program{m_programs.at(m_currentProgramIndex)};
   glUseProgram(program);
 
-  // Get location of uniform variables
-  GLint viewMatrixLoc{glGetUniformLocation(program, "viewMatrix")};
-  GLint projMatrixLoc{glGetUniformLocation(program, "projMatrix")};
-  GLint modelMatrixLoc{glGetUniformLocation(program, "modelMatrix")};
-  GLint normalMatrixLoc{glGetUniformLocation(program, "normalMatrix")};
-  GLint lightDirLoc{glGetUniformLocation(program, "lightDirWorldSpace")};
-  GLint shininessLoc{glGetUniformLocation(program, "shininess")};
-  GLint IaLoc{glGetUniformLocation(program, "Ia")};
-  GLint IdLoc{glGetUniformLocation(program, "Id")};
-  GLint IsLoc{glGetUniformLocation(program, "Is")};
-  GLint KaLoc{glGetUniformLocation(program, "Ka")};
-  GLint KdLoc{glGetUniformLocation(program, "Kd")};
-  GLint KsLoc{glGetUniformLocation(program, "Ks")};
-  GLint diffuseTexLoc{glGetUniformLocation(program, "diffuseTex")};
-  GLint normalTexLoc{glGetUniformLocation(program, "normalTex")};
-  GLint cubeTexLoc{glGetUniformLocation(program, "cubeTex")};
-  GLint mappingModeLoc{glGetUniformLocation(program, "mappingMode")};
-  GLint texMatrixLoc{glGetUniformLocation(program, "texMatrix")};
-
   // Set uniform variables used by every scene object
-  glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, &m_viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
-  glUniform1i(diffuseTexLoc, 0);
-  glUniform1i(normalTexLoc, 1);
-  glUniform1i(cubeTexLoc, 2);
-  glUniform1i(mappingModeLoc, m_mappingMode);
+  program.setUniform("diffuseTex", 0);
+  program.setUniform("normalTex", 1);
+  program.setUniform("cubeTex", 2);
+  program.setUniform("mappingMode", m_mappingMode);
 
   glm::mat3 texMatrix{m_trackBallLight.getRotation()};
-  glUniformMatrix3fv(texMatrixLoc, 1, GL_TRUE, &texMatrix[0][0]);
-
-  auto lightDirRotated{m_trackBallLight.getRotation() * m_lightDir};
-  glUniform4fv(lightDirLoc, 1, &lightDirRotated.x);
-  glUniform4fv(IaLoc, 1, &m_Ia.x);
-  glUniform4fv(IdLoc, 1, &m_Id.x);
-  glUniform4fv(IsLoc, 1, &m_Is.x);
+  program.setUniform("texMatrix", texMatrix, true);
 
   // Set uniform variables of the current object
-  glUniformMatrix4fv(modelMatrixLoc, 1, GL_FALSE, &m_modelMatrix[0][0]);
+  program.setUniform("modelMatrix", m_modelMatrix);
 
   auto modelViewMatrix{glm::mat3(m_viewMatrix * m_modelMatrix)};
   glm::mat3 normalMatrix{glm::inverseTranspose(modelViewMatrix)};
-  glUniformMatrix3fv(normalMatrixLoc, 1, GL_FALSE, &normalMatrix[0][0]);
+  program.setUniform("normalMatrix", normalMatrix);
 
-  glUniform1f(shininessLoc, m_shininess);
-  glUniform4fv(KaLoc, 1, &m_Ka.x);
-  glUniform4fv(KdLoc, 1, &m_Kd.x);
-  glUniform4fv(KsLoc, 1, &m_Ks.x);
-  m_model.render(m_trianglesToDraw);
+  program.setUniform("shininess", m_shininess);
+  program.setUniform("Ka", m_Ka);
+  program.setUniform("Kd", m_Kd);
+  program.setUniform("Ks", m_Ks);
+  {
+    ABCG_GPU_ZONE("model");
+    m_model.render(m_trianglesToDraw);
+  }
 
   if (m_currentProgramIndex == 0 || m_currentProgramIndex == 1) {
+    ABCG_GPU_ZONE("skybox");
     renderSkybox();
   }
 }
@@ -172,16 +170,11 @@ void OpenGLWindow::paintGL() {
 void OpenGLWindow::renderSkybox() {
   glUseProgram(m_skyProgram);
 
-  // Get location of uniform variables
-  GLint viewMatrixLoc{glGetUniformLocation(m_skyProgram, "viewMatrix")};
-  GLint projMatrixLoc{glGetUniformLocation(m_skyProgram, "projMatrix")};
-  GLint skyTexLoc{glGetUniformLocation(m_skyProgram, "skyTex")};
-
   // Set uniform variables
-  auto viewMatrix{m_trackBallLight.getRotation()};
-  glUniformMatrix4fv(viewMatrixLoc, 1, GL_FALSE, &viewMatrix[0][0]);
-  glUniformMatrix4fv(projMatrixLoc, 1, GL_FALSE, &m_projMatrix[0][0]);
-  glUniform1i(skyTexLoc, 0);
+  glm::mat4 viewMatrix{m_trackBallLight.getRotation()};
+  m_skyProgram.setUniform("viewMatrix", viewMatrix);
+  m_skyProgram.setUniform("projMatrix", m_projMatrix);
+  m_skyProgram.setUniform("skyTex", 0);
 
   glBindVertexArray(m_skyVAO);
 
@@ -455,6 +448,7 @@ void OpenGLWindow::resizeGL(int width, int height) {
 }
 
 void OpenGLWindow::terminateGL() {
+  m_frameUniforms.destroy();
   for (const auto& program : m_programs) {
     glDeleteProgram(program);
   }
@@ -468,6 +462,9 @@ void OpenGLWindow::terminateSkybox() {
 }
 
 void OpenGLWindow::update() {
+  // Let the application wait for input while nothing moves
+  setAnimating(m_trackBallModel.isSpinning() || m_trackBallLight.isSpinning());
+
   m_modelMatrix = m_trackBallModel.getRotation();
 
   m_eyePosition = glm::vec3(0.0f, 0.0f, 2.0f + m_zoom);
@@ -36,7 +36,8 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   const std::vector<const char*> m_shaderNames{
       "cubereflect", "cuberefract", "normalmapping", "texture", "blinnphong",
       "phong",       "gouraud",     "normal",        "depth"};
-  std::vector<GLuint> m_programs;
+  std::vector<abcg::ShaderProgram> m_programs;
+  abcg::UniformBuffer m_frameUniforms;
   int m_currentProgramIndex{};
 
   // Mapping mode
@@ -57,7 +58,7 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   const std::string m_skyShaderName{"skybox"};
   GLuint m_skyVAO{};
   GLuint m_skyVBO{};
-  GLuint m_skyProgram{};
+  abcg::ShaderProgram m_skyProgram;
 
   // clang-format off
   const std::array<glm::vec3, 36>  m_skyPositions{
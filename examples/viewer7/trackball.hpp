@@ -14,6 +14,9 @@ class TrackBall {
 
   void setAxis(glm::vec3 axis) { m_axis = axis; }
   void setVelocity(float velocity) { m_velocity = velocity; }
+  [[nodiscard]] bool isSpinning() const {
+    return !m_mouseTracking && m_velocity > 0.0f;
+  }
 
  private:
   const float m_maxVelocity{glm::radians(720.0f / 1000.0f)};